@@ -0,0 +1,199 @@
+/**
+  *****************************************************************************
+  *  _____                  ______
+  * /  __ \                 |  _  \
+  * | /  \/_ __ ___  ___ ___| | | |___   ___ ___
+  * | |   | '__/ _ \/ __/ __| | | / _ \ / __/ __|
+  * | \__/\ | | |_| \__ \__ \ |/ / |_| | (__\__ \
+  *  \____/_|  \___/|___/___/___/ \___/ \___|___/
+  *
+  *****************************************************************************
+  *
+  * @file    buildworker.cpp
+  * @author  Martin Vincent Bloedorn
+  * @version V0.1.0
+  * @date    17-October-2026
+  * @brief   Asynchronous build engine: runs the build jobs of each document.
+**/
+
+#include "buildworker.h"
+
+/**************************************** CONSTRUCTOR *******************************************/
+buildWorker::buildWorker(QObject *parent) :
+    QObject(parent),
+    nextJob(0),
+    runningJobs(0),
+    doneJobs(0),
+    maxJobs(qMax(1, QThread::idealThreadCount())),
+    running(false),
+    failed(false),
+    cancelled(false)
+{
+}
+
+buildWorker::~buildWorker() {
+    for (int i = 0; i < jobs.length(); ++i) {
+        if(jobs[i].process != NULL) {
+            jobs[i].process->disconnect(this);
+            jobs[i].process->kill();
+            jobs[i].process->waitForFinished();
+            delete jobs[i].process;
+        }
+    }
+}
+
+/**************************************** SLOTS *************************************************/
+
+void buildWorker::cancel() {
+    if(!running)
+        return;
+    cancelled = true;
+    doneJobs += jobs.length() - nextJob; // pending jobs will never run
+    nextJob = jobs.length();
+    for (int i = 0; i < jobs.length(); ++i)
+        if(jobs[i].process != NULL)
+            jobs[i].process->kill(); // finishJob() will be called from processFinished()
+}
+
+void buildWorker::processReadyReadStandardOutput() {
+    int index = indexOfJob(sender());
+    if(index == -1) return;
+    jobs[index].stdoutBuffer.append(jobs[index].process->readAllStandardOutput());
+    emitLines(jobs[index].tag, jobs[index].stdoutBuffer, false, false);
+}
+
+void buildWorker::processReadyReadStandardError() {
+    int index = indexOfJob(sender());
+    if(index == -1) return;
+    jobs[index].stderrBuffer.append(jobs[index].process->readAllStandardError());
+    emitLines(jobs[index].tag, jobs[index].stderrBuffer, true, false);
+}
+
+void buildWorker::processFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    int index = indexOfJob(sender());
+    if(index == -1) return;
+    jobs[index].stdoutBuffer.append(jobs[index].process->readAllStandardOutput());
+    jobs[index].stderrBuffer.append(jobs[index].process->readAllStandardError());
+    emitLines(jobs[index].tag, jobs[index].stdoutBuffer, false, true);
+    emitLines(jobs[index].tag, jobs[index].stderrBuffer, true,  true);
+    finishJob(index, exitStatus == QProcess::NormalExit && exitCode == 0);
+}
+
+void buildWorker::processError(QProcess::ProcessError error) {
+    // Other errors are followed by finished(), which takes care of the job
+    if(error != QProcess::FailedToStart)
+        return;
+    int index = indexOfJob(sender());
+    if(index == -1) return;
+    qWarning() << QString(__FUNCTION__) << "Unable to start" << jobs[index].program
+               << "for" << jobs[index].tag;
+    finishJob(index, false);
+}
+
+/**************************************** METHODS ***********************************************/
+
+void buildWorker::addJob(QString tag, QString program, QStringList arguments, QString workingDirectory,
+                         QByteArray input) {
+    if(running) {
+        qWarning() << QString(__FUNCTION__) << "Build already running, job" << tag << "ignored";
+        return;
+    }
+    CDC_buildJob job;
+    job.tag              = tag;
+    job.program          = program;
+    job.arguments        = arguments;
+    job.workingDirectory = workingDirectory;
+    job.input            = input;
+    job.process          = NULL;
+    jobs.append(job);
+}
+
+bool buildWorker::start() {
+    if(running)
+        return false;
+
+    nextJob     = 0;
+    runningJobs = 0;
+    doneJobs    = 0;
+    failed      = false;
+    cancelled   = false;
+
+    if(jobs.isEmpty()) {
+        emit finished(true);
+        return true;
+    }
+    running = true;
+    emit progress(0, jobs.length());
+    launchPendingJobs();
+    return true;
+}
+
+// PRIVATE ------------------------------------------------------------------------
+void buildWorker::launchPendingJobs() {
+    while(runningJobs < maxJobs && nextJob < jobs.length()) {
+        int index = nextJob++;
+        QProcess * process = new QProcess;
+        process->setProperty("cdcJobIndex", index);
+        process->setWorkingDirectory(jobs[index].workingDirectory);
+        connect(process, SIGNAL(readyReadStandardOutput()), this, SLOT(processReadyReadStandardOutput()));
+        connect(process, SIGNAL(readyReadStandardError()),  this, SLOT(processReadyReadStandardError()));
+        connect(process, SIGNAL(finished(int,QProcess::ExitStatus)), this, SLOT(processFinished(int,QProcess::ExitStatus)));
+        connect(process, SIGNAL(error(QProcess::ProcessError)), this, SLOT(processError(QProcess::ProcessError)));
+        jobs[index].process = process;
+        runningJobs++;
+
+        // start() may fail right away and end the job (and the whole build) before returning,
+        // so nothing in jobs is touched after it.
+        QByteArray input = jobs[index].input;
+        qDebug() << QString(__FUNCTION__) << "Building" << jobs[index].tag;
+        process->start(jobs[index].program, jobs[index].arguments);
+        if(!input.isEmpty())
+            process->write(input);
+        process->closeWriteChannel();
+    }
+}
+
+void buildWorker::finishJob(int index, bool ok) {
+    jobs[index].process->deleteLater();
+    jobs[index].process = NULL;
+    runningJobs--;
+    doneJobs++;
+    if(!ok)
+        failed = true;
+
+    emit jobFinished(jobs[index].tag, ok);
+    emit progress(doneJobs, jobs.length());
+
+    launchPendingJobs();
+    if(running && runningJobs == 0 && nextJob >= jobs.length()) {
+        running = false;
+        jobs.clear();
+        emit finished(!failed && !cancelled);
+    }
+}
+
+int buildWorker::indexOfJob(QObject * obj) {
+    if(obj == NULL)
+        return -1;
+    int index = obj->property("cdcJobIndex").toInt();
+    if(index >= 0 && index < jobs.length() && jobs[index].process == obj)
+        return index;
+    return -1;
+}
+
+void buildWorker::emitLines(const QString &tag, QByteArray &buffer, bool isError, bool flush) {
+    int start = 0;
+    int end;
+    while((end = buffer.indexOf('\n', start)) != -1) {
+        QByteArray line = buffer.mid(start, end - start);
+        if(line.endsWith('\r'))
+            line.chop(1);
+        emit outputLine(tag, QString::fromLocal8Bit(line), isError);
+        start = end + 1;
+    }
+    buffer.remove(0, start);
+    if(flush && !buffer.isEmpty()) {
+        emit outputLine(tag, QString::fromLocal8Bit(buffer), isError);
+        buffer.clear();
+    }
+}
@@ -0,0 +1,116 @@
+/**
+  *****************************************************************************
+  *  _____                  ______
+  * /  __ \                 |  _  \
+  * | /  \/_ __ ___  ___ ___| | | |___   ___ ___
+  * | |   | '__/ _ \/ __/ __| | | / _ \ / __/ __|
+  * | \__/\ | | |_| \__ \__ \ |/ / |_| | (__\__ \
+  *  \____/_|  \___/|___/___/___/ \___/ \___|___/
+  *
+  *****************************************************************************
+  *
+  * @file    buildworker.h
+  * @author  Martin Vincent Bloedorn
+  * @version V0.1.0
+  * @date    17-October-2026
+  * @brief   Asynchronous build engine: runs the build jobs of each document.
+**/
+
+#ifndef BUILDWORKER_H
+#define BUILDWORKER_H
+
+#include <QObject>
+#include <QDebug>
+#include <QProcess>
+#include <QThread>
+#include <QStringList>
+
+#include "cdcdefs.h"
+
+class buildWorker : public QObject
+{
+    Q_OBJECT
+public:
+    buildWorker(QObject *parent = 0);
+    ~buildWorker();
+
+    /**
+     * @brief Queues a job to be run on the next call to start().
+     * @param tag Tag of the document being built. Used to identify the job on all signals.
+     * @param program Program to be run (resolved through PATH if not absolute).
+     * @param arguments Arguments of the program.
+     * @param workingDirectory Directory the program is run from.
+     * @param input Data written to the program's stdin once it starts (stdin is then closed).
+     */
+    void addJob(QString tag, QString program, QStringList arguments, QString workingDirectory,
+                QByteArray input = QByteArray());
+
+    /**
+     * @brief Starts running the queued jobs, never more than getMaxJobs() at once.
+     * Returns right away: progress is reported through the signals. If there are no jobs,
+     * finished() is emitted before returning.
+     * @return FALSE if a build is already running.
+     */
+    bool start();
+
+    bool isRunning() { return running; }
+
+    int  getMaxJobs() { return maxJobs; }
+    void setMaxJobs(int value) { maxJobs = qMax(1, value); }
+
+signals:
+    /// A complete line of output of the job \em tag. \em isError is TRUE for lines from stderr.
+    void outputLine(QString tag, QString line, bool isError);
+    /// The job \em tag ended. \em ok is TRUE if it exited normally with status 0.
+    void jobFinished(QString tag, bool ok);
+    /// \em done out of \em total jobs ended.
+    void progress(int done, int total);
+    /// All jobs ended. \em ok is FALSE if any of them failed or if the build was cancelled.
+    void finished(bool ok);
+
+public slots:
+    /// \brief Drops the jobs that didn't start yet and kills the running ones.
+    void cancel();
+
+private slots:
+    void processReadyReadStandardOutput();
+    void processReadyReadStandardError();
+    void processFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void processError(QProcess::ProcessError error);
+
+private:
+    typedef struct {
+        QString tag;
+        QString program;
+        QStringList arguments;
+        QString workingDirectory;
+        QByteArray input;
+        QProcess * process;         /// NULL until the job is launched, and after it ends
+        QByteArray stdoutBuffer;    /// Output received that doesn't make up a full line yet
+        QByteArray stderrBuffer;
+    } CDC_buildJob;
+
+    QList<CDC_buildJob> jobs;
+    int  nextJob;       /// Index of the next job to be launched
+    int  runningJobs;
+    int  doneJobs;
+    int  maxJobs;
+    bool running;
+    bool failed;
+    bool cancelled;
+
+    // Methods
+    void launchPendingJobs();
+    void finishJob(int index, bool ok);
+
+    /// \brief Index of the job that runs the process \em obj (the signal's sender), -1 if not found.
+    int indexOfJob(QObject * obj);
+
+    /**
+     * @brief Emits outputLine() for each full line in \em buffer, removing them from it.
+     * @param flush If TRUE, whatever is left in the buffer is emitted as a last line.
+     */
+    void emitLines(const QString &tag, QByteArray &buffer, bool isError, bool flush);
+};
+
+#endif // BUILDWORKER_H
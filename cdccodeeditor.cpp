@@ -60,52 +60,85 @@
 
 #include "cdccodeeditor.h"
 
-CodeEditor::CodeEditor(QWidget *parent) : QPlainTextEdit(parent)
+CodeEditor::CodeEditor(QWidget *parent) : QPlainTextEdit(parent),
+    visibleFirst(-1),
+    visibleLast(-1),
+    visibleBlocksDirty(true),
+    gutterDigits(0)
 {
     lineNumberArea = new LineNumberArea(this);
 
     connect(this, SIGNAL(blockCountChanged(int)), this, SLOT(updateLineNumberAreaWidth(int)));
     connect(this, SIGNAL(updateRequest(QRect,int)), this, SLOT(updateLineNumberArea(QRect,int)));
     connect(this, SIGNAL(cursorPositionChanged()), this, SLOT(highlightCurrentLine()));
+    connect(this, SIGNAL(blockCountChanged(int)), this, SLOT(invalidateVisibleBlocks()));
+    connect(this, SIGNAL(textChanged()), this, SLOT(invalidateVisibleBlocks()));
 
     lineHighlightColor = QColor(Qt::yellow).lighter(160);
 
-    updateLineNumberAreaWidth(0);
+    updateDigitMetrics();
     highlightCurrentLine();
 }
 
 int CodeEditor::lineNumberAreaWidth()
 {
-    int digits = 1;
-    int max = qMax(1, blockCount());
-    while (max >= 10) {
-        max /= 10;
-        ++digits;
-    }
-
-    int space = 3 + fontMetrics().width(QLatin1Char('9')) * digits;
-
-    return space;
+    return lineNumbers.widthFor(gutterDigits);
 }
 
 void CodeEditor::setText(QString text) {
     this->document()->setPlainText(text);
 }
 
+void CodeEditor::swapDocument(QTextDocument * document) {
+    setDocument(document);
+    // The next update emits visibleBlocksChanged() for the new document, even if the range is the same
+    visibleFirst = -1;
+    visibleLast  = -1;
+    visibleBlocksDirty = true;
+    updateLineNumberAreaWidth(0);
+}
+
 void CodeEditor::updateLineNumberAreaWidth(int /* newBlockCount */)
 {
+    // Only relayout when the number of digits changes, not on every block added or removed
+    int digits = cdcLineNumberPainter::digitsFor(blockCount());
+    if (digits == gutterDigits)
+        return;
+    gutterDigits = digits;
     setViewportMargins(lineNumberAreaWidth(), 0, 0, 0);
+
+    QRect cr = contentsRect();
+    lineNumberArea->setGeometry(QRect(cr.left(), cr.top(), lineNumberAreaWidth(), cr.height()));
 }
 
 void CodeEditor::updateLineNumberArea(const QRect &rect, int dy)
 {
+    // Scrolling moves the pixels already painted: only the band scrolled in gets repainted
     if (dy)
         lineNumberArea->scroll(0, dy);
     else
         lineNumberArea->update(0, rect.y(), lineNumberArea->width(), rect.height());
 
-    if (rect.contains(viewport()->rect()))
-        updateLineNumberAreaWidth(0);
+    // Most requests (e.g. the cursor blinking) leave the range as it was
+    if (dy || visibleBlocksDirty)
+        updateVisibleBlocks();
+}
+
+void CodeEditor::invalidateVisibleBlocks()
+{
+    visibleBlocksDirty = true;
+}
+
+void CodeEditor::updateVisibleBlocks()
+{
+    visibleBlocksDirty = false;
+    int first = firstVisibleBlock().blockNumber();
+    int last  = cursorForPosition(QPoint(0, viewport()->height() - 1)).blockNumber();
+    if (first != visibleFirst || last != visibleLast) {
+        visibleFirst = first;
+        visibleLast  = last;
+        emit visibleBlocksChanged(first, last);
+    }
 }
 
 //![slotUpdateRequest]
@@ -118,6 +151,16 @@ void CodeEditor::resizeEvent(QResizeEvent *e)
 
     QRect cr = contentsRect();
     lineNumberArea->setGeometry(QRect(cr.left(), cr.top(), lineNumberAreaWidth(), cr.height()));
+    updateVisibleBlocks();
+}
+
+void CodeEditor::changeEvent(QEvent *e)
+{
+    QPlainTextEdit::changeEvent(e);
+    if (e->type() == QEvent::FontChange) {
+        updateDigitMetrics();
+        visibleBlocksDirty = true;
+    }
 }
 
 void CodeEditor::highlightCurrentLine()
@@ -149,10 +192,7 @@ void CodeEditor::lineNumberAreaPaintEvent(QPaintEvent *event)
 
     while (block.isValid() && top <= event->rect().bottom()) {
         if (block.isVisible() && bottom >= event->rect().top()) {
-            QString number = QString::number(blockNumber + 1);
-            painter.setPen(Qt::black);
-            painter.drawText(0, top, lineNumberArea->width(), fontMetrics().height(),
-                             Qt::AlignRight, number);
+            lineNumbers.drawNumber(&painter, lineNumberArea->width(), top, blockNumber + 1);
         }
 
         block = block.next();
@@ -162,3 +202,10 @@ void CodeEditor::lineNumberAreaPaintEvent(QPaintEvent *event)
     }
 }
 
+void CodeEditor::updateDigitMetrics()
+{
+    lineNumbers.setFont(font());
+    gutterDigits = 0; // force the width to be set again
+    updateLineNumberAreaWidth(0);
+    lineNumberArea->update();
+}
@@ -62,6 +62,8 @@
 #include <QPlainTextEdit>
 #include <QObject>
 
+#include "cdclinenumberpainter.h"
+
 QT_BEGIN_NAMESPACE
 class QPaintEvent;
 class QResizeEvent;
@@ -83,20 +85,39 @@ public:
 
     void setText(QString text);
 
+    /// \brief Shows \em document (see \b QPlainTextEdit::setDocument ), and reports its visible blocks anew.
+    void swapDocument(QTextDocument * document);
+
     QColor getLineHighlightColor()                  { return lineHighlightColor;  }
     void setLineHighlightColor(const QColor &value) { lineHighlightColor = value; }
 
+signals:
+    /// \brief Emitted when the range of blocks on screen changes (e.g. on scroll or resize).
+    void visibleBlocksChanged(int first, int last);
+
 protected:
     void resizeEvent(QResizeEvent *event);
+    void changeEvent(QEvent *event);
     QColor lineHighlightColor;
 
 private slots:
     void updateLineNumberAreaWidth(int newBlockCount);
     void highlightCurrentLine();
     void updateLineNumberArea(const QRect &, int);
+    void invalidateVisibleBlocks();
 
 private:
     QWidget *lineNumberArea;
+    int visibleFirst;   /// First block on screen, as last reported by visibleBlocksChanged()
+    int visibleLast;    /// Last block on screen, as last reported by visibleBlocksChanged()
+    bool visibleBlocksDirty; /// The range may have moved without a scroll: find it again on the next update
+    int gutterDigits;   /// Digits the line number area is currently sized for
+    cdcLineNumberPainter lineNumbers;
+
+    /// \brief Gives the editor's font to lineNumbers , and sizes the line number area again.
+    void updateDigitMetrics();
+    /// \brief Finds the blocks on screen, and emits visibleBlocksChanged() if they changed.
+    void updateVisibleBlocks();
 };
 
 
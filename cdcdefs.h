@@ -23,6 +23,9 @@
 #include <QStringList>
 #include <QFile>
 #include <QVariant>
+#include <QSharedPointer>
+
+#include "piecetable.h"
 
 /* Types --------------------------------------------------------------------*/
 
@@ -95,7 +98,63 @@ typedef struct {
     CDC_docStructuralElementType type; /// Identifies the type of the element (section? paragraph? ...)
 } CDC_docStructuralElement;
 
-/// Role definitions used to store Structural Element's data in QVariant containers on a QStandardModel structure
+/// Where a structural element can be found in the project. Value type of the structural tag indexes.
+typedef struct {
+    QString doc;        /// Tag of the document the element belongs to
+    int fileIndex;      /// Index of the input file in the document's IFlist
+    int line;           /// Line number where the structural element was found
+    int index;          /// Index (column) where the structural element was found
+    CDC_docStructuralElementType type; /// Type of the element
+} CDC_docStructuralElementLocation;
+
+/// Spans of a structural command found in a line. Offsets are relative to the start of the scanned line.
+typedef struct {
+    CDC_docStructuralElementType type; /// Which command was found (section? paragraph? ...)
+    int index;          /// Column of the command's leading backslash
+    int commandLength;  /// Length of the command, backslash included
+    int tagStart;       /// Column where the tag starts
+    int tagLength;      /// Length of the tag
+    int nameStart;      /// Column where the name starts
+    int nameLength;     /// Length of the name (runs until the end of the line)
+} CDC_structuralCommand;
+
+/// Size and modification time of a file, used to tell whether it changed
+typedef struct {
+    qint64 size;            /// -1 if the file doesn't exist (or isn't known)
+    qint64 modified;        /// Milliseconds since epoch
+} CDC_fileStamp;
+
+/// Contents of one input file. Shared by all documents that include the file.
+typedef struct {
+    pieceTable contents;    /// Loaded plain-text contents (empty until loaded)
+    bool modified;          /// TRUE if the contents were modified and not saved
+    int revision;           /// Incremented every time the contents change
+    CDC_fileStamp stamp;    /// File as the contents were last read from or saved to (size -1 if never)
+} CDC_inputFileBuffer;
+
+/// Reference-counted handle to an input file buffer.
+typedef QSharedPointer<CDC_inputFileBuffer> CDC_inputFileHandle;
+
+/// Everything needed to extract the structure of one input file away from its documentWorker
+typedef struct {
+    int index;                      /// Index of the input file in the document
+    int revision;                   /// Buffer revision the job was taken from
+    CDC_fileSyntax syntax;          /// Syntax of the input file
+    QString filePath;               /// If not empty, the file is scanned straight from disk
+    pieceTable contents;            /// Otherwise, snapshot of the contents (O(1) to take)
+    CDC_fileStamp stamp;            /// File as scanned from disk, taken before reading it (size -1 otherwise)
+    QList<CDC_docStructuralElement> elements; /// Result of the extraction
+} CDC_structureJob;
+
+/// One input file to be written by projectWorker::saveAllInputFiles()
+typedef struct {
+    QString filePath;               /// Canonical path of the input file
+    pieceTable contents;            /// Snapshot of the buffer (O(1) to take)
+    int revision;                   /// Buffer revision the snapshot was taken from
+    bool ok;                        /// Whether the file was written
+} CDC_saveJob;
+
+/// Role definitions used to expose Structural Element's data through the project structure model (see structureModel)
 enum CDC_docStructuralElementRole {
     Tag     = Qt::UserRole+1,   /// Structural element's tag
     Line    = Qt::UserRole+2,   /// Line where structural element was found
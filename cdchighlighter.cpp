@@ -18,11 +18,32 @@
 
 #include "cdchighlighter.h"
 
+// Blocks around the visible ones that are highlighted right away in lazy mode
+const int visibleBlockMargin = 50;
+// Time spent on pending blocks before going back to the event loop, in lazy mode
+const int lazyBudgetMs = 10;
+
 /**************************************** CONSTRUCTOR *******************************************/
 cdcHighlighter::cdcHighlighter(QTextDocument *parent) :
     QSyntaxHighlighter(parent),
-    currentSyntax(CDC_fileSyntax::none)
+    currentSyntax(CDC_fileSyntax::none),
+    visibleFirst(0),
+    visibleLast(0),
+    forcedBlock(-1),
+    nextPendingBlock(0),
+    formatting(false)
 {
+    SEFormat.setForeground(Qt::darkBlue);
+    SEFormat.setFontWeight(QFont::Bold);
+    tagFormat.setForeground(Qt::darkGreen);
+    tagFormat.setFontWeight(QFont::Bold);
+    nameFormat.setForeground(Qt::darkBlue);
+
+    lazyTimer = new QTimer(this);
+    lazyTimer->setSingleShot(true);
+    lazyTimer->setInterval(0);
+    connect(lazyTimer, SIGNAL(timeout()), this, SLOT(highlightPendingBlocks()));
+
     setSyntax(CDC_fileSyntax::doxygen); // just defaulting
 }
 
@@ -31,53 +52,77 @@ cdcHighlighter::~cdcHighlighter() {
 }
 
 /**************************************** SLOTS *************************************************/
+void cdcHighlighter::setVisibleBlocks(int first, int last) {
+    visibleFirst = first;
+    visibleLast  = last;
+    if(document() != NULL && document()->blockCount() > lazyBlockCount)
+        highlightPendingRange(first - visibleBlockMargin, last + visibleBlockMargin, NULL);
+}
+
+void cdcHighlighter::highlightPendingBlocks() {
+    if(document() == NULL)
+        return;
+    QElapsedTimer budget;
+    budget.start();
+    highlightPendingRange(nextPendingBlock, document()->blockCount() - 1, &budget);
+    if(nextPendingBlock < document()->blockCount())
+        lazyTimer->start();
+}
 
 /**************************************** METHODS ***********************************************/
 void cdcHighlighter::setSyntax(CDC_fileSyntax syntax) {
-    structuralRules.clear();
-    structuralRule strucRule;
-
-    switch (syntax) {
-    case CDC_fileSyntax::doxygen:
-        currentSyntax = syntax;
-        strucRule.SEGroup   = 1;
-        strucRule.tagGroup  = 3;
-        strucRule.nameGroup = 5;
-        strucRule.SEtagPaddingGroup   = 2;
-        strucRule.tagNamePaddingGroup = 4;
-        strucRule.SEFormat.setForeground(Qt::darkBlue);
-        strucRule.SEFormat.setFontWeight(QFont::Bold);
-        strucRule.tagFormat.setForeground(Qt::darkGreen);
-        strucRule.tagFormat.setFontWeight(QFont::Bold);
-        strucRule.nameFormat.setForeground(Qt::darkBlue);
-        strucRule.regexp = QRegExp("(\\\\section)(\\s+)(\\w+)(\\s+)(.*)"); // Section rule
-        structuralRules.append(strucRule);
-        strucRule.regexp = QRegExp("(\\\\subsection)(\\s+)(\\w+)(\\s+)(.*)"); // Subsection rule
-        structuralRules.append(strucRule);
-        strucRule.regexp = QRegExp("(\\\\subsubsection)(\\s+)(\\w+)(\\s+)(.*)"); // Subsubsection rule
-        structuralRules.append(strucRule);
-        strucRule.regexp = QRegExp("(\\\\paragraph)(\\s+)(\\w+)(\\s+)(.*)"); // Paragraph rule
-        structuralRules.append(strucRule);
-        break;
-    case CDC_fileSyntax::none:
-    default:
-            syntax = CDC_fileSyntax::none;
-        break;
-    }
+    if(syntax == currentSyntax)
+        return;
+    currentSyntax = syntax;
+    formatting = true;
+    rehighlight();
+    formatting = false;
 }
 
 void cdcHighlighter::highlightBlock(const QString &text) {
+    int blockNumber = currentBlock().blockNumber();
+
+    // Lazy mode: blocks off screen that were never highlighted wait for highlightPendingBlocks()
+    if(document()->blockCount() > lazyBlockCount && blockNumber != forcedBlock
+            && currentBlockState() != highlightedState && !isVisibleBlock(blockNumber)) {
+        setCurrentBlockState(pendingState);
+        if(blockNumber < nextPendingBlock)
+            nextPendingBlock = blockNumber;
+        if(!lazyTimer->isActive())
+            lazyTimer->start();
+        return;
+    }
+    setCurrentBlockState(highlightedState);
 
-    setCurrentBlockState(0);
+    CDC_structuralCommand command;
+    if(!inputFileParser::scanStructuralCommand(currentSyntax, text.constData(), text.length(), command))
+        return;
+    setFormat(command.index,     command.commandLength, SEFormat);
+    setFormat(command.tagStart,  command.tagLength,     tagFormat);
+    setFormat(command.nameStart, command.nameLength,    nameFormat);
+}
+
+// PRIVATE ------------------------------------------------------------------------
+bool cdcHighlighter::isVisibleBlock(int blockNumber) {
+    return blockNumber >= visibleFirst - visibleBlockMargin && blockNumber <= visibleLast + visibleBlockMargin;
+}
 
-    foreach (const structuralRule &rule, structuralRules) {
-       int index = rule.regexp.indexIn(text);
-       if(index >= 0) {
-           setFormat(index, rule.regexp.cap(rule.SEGroup).length(), rule.SEFormat);
-           index += rule.regexp.cap(rule.SEGroup).length() + rule.regexp.cap(rule.SEtagPaddingGroup).length();
-           setFormat(index, rule.regexp.cap(rule.tagGroup).length(), rule.tagFormat);
-           index += rule.regexp.cap(rule.tagGroup).length() + rule.regexp.cap(rule.tagNamePaddingGroup).length();
-           setFormat(index, rule.regexp.cap(rule.nameGroup).length(), rule.nameFormat);
-       }
+void cdcHighlighter::highlightPendingRange(int first, int last, const QElapsedTimer * budget) {
+    QTextBlock block = document()->findBlockByNumber(qMax(first, 0));
+    while(block.isValid() && block.blockNumber() <= last) {
+        if(block.userState() == pendingState) {
+            // Only this block gets forced: the next one keeps its state, so highlighting stops there
+            forcedBlock = block.blockNumber();
+            formatting  = true;
+            rehighlightBlock(block);
+            formatting  = false;
+            forcedBlock = -1;
+        }
+        block = block.next();
+        if(budget != NULL) {
+            nextPendingBlock = block.isValid() ? block.blockNumber() : document()->blockCount();
+            if(budget->elapsed() >= lazyBudgetMs)
+                return;
+        }
     }
 }
@@ -21,9 +21,25 @@
 
 #include <QObject>
 #include <QSyntaxHighlighter>
+#include <QTextDocument>
+#include <QTimer>
+#include <QElapsedTimer>
 
 #include "cdcdefs.h"
+#include "inputfileparser.h"
 
+/**
+ * @brief Highlights the structural commands (sections, subsections...) of an input file.
+ * Each block is matched once with inputFileParser::scanStructuralCommand() , which finds any structural
+ * command of the current syntax in a single pass. Highlighting only depends on the block itself.
+ * The block state only tells whether a block was highlighted (highlightedState ) or is still waiting
+ * (pendingState ). Re-highlighting a block keeps its state, so edits are not propagated to the blocks
+ * that follow.
+ * Documents with more than lazyBlockCount blocks are highlighted lazily: only the visible blocks (see
+ * setVisibleBlocks() ) are highlighted right away, the others are marked as pending and filled in
+ * from the event loop, a few at a time. A pending block that gets highlighted changes state; the block
+ * after it is then matched again, but stays pending, so the change goes no further.
+ */
 class cdcHighlighter : public QSyntaxHighlighter
 {
     Q_OBJECT
@@ -33,47 +49,54 @@ public:
     ~cdcHighlighter();
 
     void setSyntax(CDC_fileSyntax syntax);
+    CDC_fileSyntax getSyntax() { return currentSyntax; }
+
+    /**
+     * @brief Whether the highlighter is reformatting blocks on its own (lazy highlighting, syntax change).
+     * The document reports those format-only changes through \b QTextDocument::contentsChange too.
+     */
+    bool isFormatting() { return formatting; }
+
+    /// Number of blocks above which documents are highlighted lazily
+    static const int lazyBlockCount = 20000;
+
+public slots:
+    /**
+     * @brief Tells the highlighter which blocks are on screen, so they are highlighted first.
+     * @param first Number of the first visible block.
+     * @param last Number of the last visible block.
+     */
+    void setVisibleBlocks(int first, int last);
 
 protected:
     void highlightBlock(const QString &text);
 
+private slots:
+    /// \brief Highlights pending blocks for a few milliseconds, and reschedules itself if any is left.
+    void highlightPendingBlocks();
+
 private:
+    /// Block states. New blocks start at -1.
+    enum {
+        highlightedState = 0,   /// Block was highlighted
+        pendingState     = 1    /// Block was skipped in lazy mode, and still has to be highlighted
+    };
+
     CDC_fileSyntax currentSyntax;
 
-    /** Strucutre that contains the information to highlight the structural elements of a text in each syntax.
-     *  Let's assume a \em doxygen syntax example. The regexp used for detecting a \b section keyword is:
-     *  \code
-     *      (\\\\section)(\\s+)(\\w+)(\\s+)(.*)
-     *  \endcode
-     *  The regexp divides the search in five groups:
-     *      + \b 1: Has the \b section keyword stored. The SEFormat will be applied to it.
-     *      + \b 2: Has all the whitespaces between the \b SE command and the SE tag. No format is applied, it is used to offset the next format accordingly.
-     *      + \b 3: Has the \b tag. The tagFormat will be applied to it.
-     *      + \b 4: Has all the whitespaces between the \b SE tag and the SE name. No format is applied, it is used to offset the next format accordingly.
-     *      + \b 3: Has the \b name. The nameFormat will be applied to it.
-     *  That group numeration is stored in all the integers in this struct. If it doesnt apply for any given syntax,
-     *  just set it to -1.
-     */
-    struct structuralRule {
-        QRegExp regexp;
-        QTextCharFormat SEFormat;
-        QTextCharFormat tagFormat;
-        QTextCharFormat nameFormat;
-        int SEGroup;
-        int tagGroup;
-        int nameGroup;
-        int SEtagPaddingGroup;   /// Index of the group in the regexp that captures the whitespaces between the SE and tag
-        int tagNamePaddingGroup; /// Index of the group in the regexp that captures the whitespaces between the tag and name
-    };
-    QList<structuralRule> structuralRules;
+    /// Formats applied to the spans of a structural command (see CDC_structuralCommand )
+    QTextCharFormat SEFormat;   /// Command keyword (e.g. \\section)
+    QTextCharFormat tagFormat;  /// Tag of the structural element
+    QTextCharFormat nameFormat; /// Name of the structural element
 
-    struct HighlightingRule
-    {
-        QRegExp pattern;
-        QTextCharFormat format;
-    };
-    QVector<HighlightingRule> highlightingRules;
+    int visibleFirst;       /// First visible block
+    int visibleLast;        /// Last visible block
+    int forcedBlock;        /// Block being highlighted by highlightPendingBlocks() (-1 if none)
+    int nextPendingBlock;   /// Where highlightPendingBlocks() resumes looking for pending blocks
+    bool formatting;        /// A rehighlight started by the highlighter itself is running
+    QTimer * lazyTimer;
 
+    bool isVisibleBlock(int blockNumber);
+    void highlightPendingRange(int first, int last, const QElapsedTimer * budget);
 };
-
 #endif // CDCHIGHLIGHTER_H
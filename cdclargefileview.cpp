@@ -0,0 +1,330 @@
+/**
+  *****************************************************************************
+  *  _____                  ______
+  * /  __ \                 |  _  \
+  * | /  \/_ __ ___  ___ ___| | | |___   ___ ___
+  * | |   | '__/ _ \/ __/ __| | | / _ \ / __/ __|
+  * | \__/\ | | |_| \__ \__ \ |/ / |_| | (__\__ \
+  *  \____/_|  \___/|___/___/___/ \___/ \___|___/
+  *
+  *****************************************************************************
+  *
+  * @file    cdclargefileview.cpp
+  * @author  Martin Vincent Bloedorn
+  * @version V0.1.0
+  * @date    17-October-2026
+  * @brief   Paged, read-only view for input files too big for the editor.
+**/
+
+#include "cdclargefileview.h"
+
+#include <QPainter>
+#include <QScrollBar>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QFileInfo>
+#include <QDebug>
+#include <QtMath>
+
+#include <cstring>
+
+// Bytes of a line that are decoded and shown: longer lines (e.g. generated data) are cut there
+const int maxLineBytes = 16 * 1024;
+// Space between the line numbers and the text
+const int textMargin   = 4;
+
+/**************************************** CONSTRUCTOR *******************************************/
+cdcLargeFileView::cdcLargeFileView(QWidget *parent) :
+    QAbstractScrollArea(parent),
+    data(NULL),
+    size(0),
+    lineCount(0),
+    currentLine(0),
+    currentSyntax(CDC_fileSyntax::doxygen),
+    widestLine(0),
+    gutterWidth(0)
+{
+    // Same formats as cdcHighlighter
+    SEFormat.setForeground(Qt::darkBlue);
+    SEFormat.setFontWeight(QFont::Bold);
+    tagFormat.setForeground(Qt::darkGreen);
+    tagFormat.setFontWeight(QFont::Bold);
+    nameFormat.setForeground(Qt::darkBlue);
+
+    lineNumbers.setFont(font());
+    watcher = new QFileSystemWatcher(this);
+    connect(watcher, SIGNAL(fileChanged(QString)), this, SLOT(fileChanged()));
+
+    verticalScrollBar()->setSingleStep(1);
+    updateGutter();
+    updateScrollBars();
+}
+
+cdcLargeFileView::~cdcLargeFileView() {
+    closeFile();
+}
+
+/**************************************** METHODS ***********************************************/
+bool cdcLargeFileView::openFile(const QString &path) {
+    closeFile();
+    file.setFileName(path);
+    if(!file.open(QIODevice::ReadOnly)) {
+        qWarning() << QString(__FUNCTION__) << "Unable to open" << path << ":" << file.errorString();
+        return false;
+    }
+    size = file.size();
+    if(size > 0) {
+        data = reinterpret_cast<const char *>(file.map(0, size));
+        if(data == NULL) {
+            qWarning() << QString(__FUNCTION__) << "Unable to map" << path << ":" << file.errorString();
+            file.close();
+            size = 0;
+            return false;
+        }
+    }
+    filePath       = path;
+    mappedModified = QFileInfo(file).lastModified();
+    watcher->addPath(path);
+    buildLineIndex();
+
+    updateGutter();
+    verticalScrollBar()->setValue(0);
+    horizontalScrollBar()->setValue(0);
+    updateScrollBars();
+    viewport()->update();
+    return true;
+}
+
+bool cdcLargeFileView::reload() {
+    if(filePath.isEmpty())
+        return false;
+    if(isMapCurrent())
+        return true;
+    QString path = filePath;
+    int top      = verticalScrollBar()->value();
+    int left     = horizontalScrollBar()->value();
+    int line     = currentLine;
+    if(!openFile(path))
+        return false;
+    currentLine = qMin(line, lineCount - 1);
+    verticalScrollBar()->setValue(top);
+    horizontalScrollBar()->setValue(left);
+    return true;
+}
+
+void cdcLargeFileView::closeFile() {
+    clearLayouts();
+    if(data != NULL)
+        file.unmap(reinterpret_cast<uchar *>(const_cast<char *>(data)));
+    file.close();
+    if(!watcher->files().isEmpty())
+        watcher->removePaths(watcher->files());
+    data = NULL;
+    size = 0;
+    filePath.clear();
+    checkpoints.clear();
+    lineCount   = 0;
+    currentLine = 0;
+    widestLine  = 0;
+
+    updateGutter();
+    updateScrollBars();
+    viewport()->update();
+}
+
+void cdcLargeFileView::goToLine(int line) {
+    if(lineCount == 0)
+        return;
+    currentLine = qBound(0, line, lineCount - 1);
+    int first = verticalScrollBar()->value();
+    if(currentLine < first || currentLine >= first + visibleLines())
+        verticalScrollBar()->setValue(currentLine);
+    viewport()->update();
+}
+
+void cdcLargeFileView::setSyntax(CDC_fileSyntax syntax) {
+    if(syntax == currentSyntax)
+        return;
+    currentSyntax = syntax;
+    clearLayouts();
+    viewport()->update();
+}
+
+void cdcLargeFileView::paintEvent(QPaintEvent *event) {
+    QPainter painter(viewport());
+    int height = fontMetrics().height();
+    int first  = verticalScrollBar()->value();
+    int last   = qMin(lineCount - 1, first + visibleLines());
+
+    // Only the lines on screen stay laid out
+    QHash<int, QTextLayout *>::iterator it = layouts.begin();
+    while(it != layouts.end()) {
+        if(it.key() < first || it.key() > last) {
+            delete it.value();
+            it = layouts.erase(it);
+        }
+        else
+            ++it;
+    }
+
+    int widest = widestLine;
+    QRect textArea(gutterWidth, 0, viewport()->width() - gutterWidth, viewport()->height());
+    painter.setClipRect(textArea & event->rect());
+    QPointF origin(gutterWidth + textMargin - horizontalScrollBar()->value(), 0);
+    for (int line = first; line <= last; ++line) {
+        int top = (line - first) * height;
+        if(line == currentLine)
+            painter.fillRect(QRect(gutterWidth, top, textArea.width(), height), QColor(Qt::yellow).lighter(160));
+        layoutLine(line)->draw(&painter, origin + QPointF(0, top));
+    }
+
+    painter.setClipRect(event->rect());
+    painter.fillRect(QRect(0, 0, gutterWidth, viewport()->height()), Qt::lightGray);
+    for (int line = first; line <= last; ++line)
+        lineNumbers.drawNumber(&painter, gutterWidth, (line - first) * height, line + 1);
+
+    if(widestLine != widest)
+        updateScrollBars();
+}
+
+void cdcLargeFileView::resizeEvent(QResizeEvent *event) {
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void cdcLargeFileView::changeEvent(QEvent *event) {
+    QAbstractScrollArea::changeEvent(event);
+    if(event->type() == QEvent::FontChange) {
+        clearLayouts();
+        widestLine = 0;
+        lineNumbers.setFont(font());
+        updateGutter();
+        updateScrollBars();
+        viewport()->update();
+    }
+}
+
+void cdcLargeFileView::mousePressEvent(QMouseEvent *event) {
+    int line = verticalScrollBar()->value() + event->pos().y() / fontMetrics().height();
+    if(line < lineCount) {
+        currentLine = line;
+        viewport()->update();
+    }
+    QAbstractScrollArea::mousePressEvent(event);
+}
+
+void cdcLargeFileView::scrollContentsBy(int dx, int dy) {
+    Q_UNUSED(dx);
+    Q_UNUSED(dy);
+    viewport()->update(); // Lines are painted from the scroll bars' values, nothing to move
+}
+
+void cdcLargeFileView::fileChanged() {
+    reload(); // right away: the map may already reach past the end of the file
+}
+
+// PRIVATE ------------------------------------------------------------------------
+bool cdcLargeFileView::isMapCurrent() const {
+    QFileInfo info(filePath);
+    // A deleted (or renamed over) file stays mapped as it was, reading it is safe
+    if(!info.exists())
+        return true;
+    return info.size() == size && info.lastModified() == mappedModified;
+}
+
+void cdcLargeFileView::buildLineIndex() {
+    checkpoints.clear();
+    checkpoints.append(0);
+    lineCount = 1; // Like QTextDocument: a trailing newline starts one last, empty line
+
+    const char * end = data + size;
+    const char * p   = data;
+    while(p < end) {
+        const char * newline = static_cast<const char *>(memchr(p, '\n', end - p));
+        if(newline == NULL)
+            break;
+        p = newline + 1;
+        if(lineCount % checkpointInterval == 0) // lineCount is the number of the line starting at p
+            checkpoints.append(p - data);
+        lineCount++;
+    }
+}
+
+void cdcLargeFileView::lineSpan(int line, qint64 &start, qint64 &length) const {
+    start  = checkpoints[line / checkpointInterval];
+    length = 0;
+    if(size == 0)
+        return;
+    for (int i = line % checkpointInterval; i > 0; --i)
+        start = static_cast<const char *>(memchr(data + start, '\n', size - start)) - data + 1;
+
+    const char * newline = static_cast<const char *>(memchr(data + start, '\n', size - start));
+    qint64 end = newline != NULL ? newline - data : size;
+    if(end > start && data[end - 1] == '\r')
+        end--;
+    length = end - start;
+}
+
+QTextLayout * cdcLargeFileView::layoutLine(int line) {
+    QTextLayout * layout = layouts.value(line);
+    if(layout != NULL)
+        return layout;
+
+    qint64 start, length;
+    lineSpan(line, start, length);
+    QString text = QString::fromUtf8(data + start, static_cast<int>(qMin<qint64>(length, maxLineBytes)));
+
+    layout = new QTextLayout(text, font());
+    QTextOption option;
+    option.setWrapMode(QTextOption::NoWrap);
+    layout->setTextOption(option);
+
+    CDC_structuralCommand command;
+    if(inputFileParser::scanStructuralCommand(currentSyntax, text.constData(), text.length(), command)) {
+        QList<QTextLayout::FormatRange> ranges;
+        QTextLayout::FormatRange range;
+        range.start = command.index;     range.length = command.commandLength; range.format = SEFormat;
+        ranges.append(range);
+        range.start = command.tagStart;  range.length = command.tagLength;     range.format = tagFormat;
+        ranges.append(range);
+        range.start = command.nameStart; range.length = command.nameLength;    range.format = nameFormat;
+        ranges.append(range);
+        layout->setAdditionalFormats(ranges);
+    }
+
+    layout->beginLayout();
+    QTextLine textLine = layout->createLine();
+    if(textLine.isValid()) {
+        textLine.setLineWidth(QWIDGETSIZE_MAX);
+        textLine.setPosition(QPointF(0, 0));
+        widestLine = qMax(widestLine, qCeil(textLine.naturalTextWidth()));
+    }
+    layout->endLayout();
+
+    layouts.insert(line, layout);
+    return layout;
+}
+
+void cdcLargeFileView::clearLayouts() {
+    qDeleteAll(layouts);
+    layouts.clear();
+}
+
+void cdcLargeFileView::updateGutter() {
+    gutterWidth = lineNumbers.widthFor(cdcLineNumberPainter::digitsFor(lineCount));
+}
+
+void cdcLargeFileView::updateScrollBars() {
+    int visible = visibleLines();
+    verticalScrollBar()->setRange(0, qMax(0, lineCount - visible));
+    verticalScrollBar()->setPageStep(visible);
+
+    int textWidth = viewport()->width() - gutterWidth - textMargin;
+    horizontalScrollBar()->setRange(0, qMax(0, widestLine - textWidth));
+    horizontalScrollBar()->setPageStep(qMax(1, textWidth));
+    horizontalScrollBar()->setSingleStep(fontMetrics().width(QLatin1Char('x')));
+}
+
+int cdcLargeFileView::visibleLines() const {
+    return qMax(1, viewport()->height() / fontMetrics().height());
+}
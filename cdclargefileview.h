@@ -0,0 +1,114 @@
+/**
+  *****************************************************************************
+  *  _____                  ______
+  * /  __ \                 |  _  \
+  * | /  \/_ __ ___  ___ ___| | | |___   ___ ___
+  * | |   | '__/ _ \/ __/ __| | | / _ \ / __/ __|
+  * | \__/\ | | |_| \__ \__ \ |/ / |_| | (__\__ \
+  *  \____/_|  \___/|___/___/___/ \___/ \___|___/
+  *
+  *****************************************************************************
+  *
+  * @file    cdclargefileview.h
+  * @author  Martin Vincent Bloedorn
+  * @version V0.1.0
+  * @date    17-October-2026
+  * @brief   Paged, read-only view for input files too big for the editor.
+**/
+
+#ifndef CDCLARGEFILEVIEW_H
+#define CDCLARGEFILEVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QDateTime>
+#include <QVector>
+#include <QHash>
+#include <QTextLayout>
+
+#include "cdcdefs.h"
+#include "inputfileparser.h"
+#include "cdclinenumberpainter.h"
+
+/**
+ * @brief Shows a file of any size without loading it: the file is memory-mapped, so the system pages
+ * in only the parts that are looked at.
+ * When a file is opened, only a sparse line index is built (the offset of every checkpointInterval-th
+ * line). Lines are then decoded, highlighted and laid out only while they are on screen; the layouts
+ * of the lines that scroll out are dropped. Structural commands get the same formats as cdcHighlighter .
+ * The view is read-only: line numbers, scrolling and jumping to a line (goToLine() ) are what it offers.
+ * A file rewritten in place would make reads past its new end fault, so the map is replaced as soon as
+ * the watcher reports a change. Line numbers are painted like the editor's (see cdcLineNumberPainter ).
+ */
+class cdcLargeFileView : public QAbstractScrollArea
+{
+    Q_OBJECT
+public:
+    cdcLargeFileView(QWidget *parent = 0);
+    ~cdcLargeFileView();
+
+    /// \brief Maps and indexes \em path , replacing the file shown. Returns FALSE if it can't be mapped.
+    bool openFile(const QString &path);
+    /// \brief Maps the file shown again if it changed on disk, keeping the scroll position.
+    bool reload();
+    void closeFile();
+    QString getFilePath() { return filePath; }
+
+    int getLineCount() { return lineCount; }
+    /// \brief Line last jumped to or clicked (0-based), marked like the editor's current line.
+    int getCurrentLine() { return currentLine; }
+    /// \brief Scrolls to \em line (0-based) and makes it the current line.
+    void goToLine(int line);
+
+    void setSyntax(CDC_fileSyntax syntax);
+    CDC_fileSyntax getSyntax() { return currentSyntax; }
+
+    /// Lines between two entries of the line index
+    static const int checkpointInterval = 64;
+
+protected:
+    void paintEvent(QPaintEvent *event);
+    void resizeEvent(QResizeEvent *event);
+    void changeEvent(QEvent *event);
+    void mousePressEvent(QMouseEvent *event);
+    void scrollContentsBy(int dx, int dy);
+
+private:
+    QFile file;
+    QString filePath;
+    const char * data;              /// Mapped contents (NULL for an empty file)
+    qint64 size;
+    QDateTime mappedModified;       /// Modification time of the file when it was mapped
+    QFileSystemWatcher * watcher;
+
+    QVector<qint64> checkpoints;    /// Offset of every checkpointInterval-th line
+    int lineCount;
+    int currentLine;
+
+    CDC_fileSyntax currentSyntax;
+    QTextCharFormat SEFormat;
+    QTextCharFormat tagFormat;
+    QTextCharFormat nameFormat;
+
+    QHash<int, QTextLayout *> layouts; /// Laid out lines, by line number: only those last painted are kept
+    int widestLine;                 /// Widest line laid out so far, in pixels
+    int gutterWidth;
+    cdcLineNumberPainter lineNumbers;
+
+    /// \brief Whether the file still has the size and modification time it was mapped with.
+    bool isMapCurrent() const;
+    void buildLineIndex();
+    /// \brief Gets where \em line starts in the file, and its length without the line terminator.
+    void lineSpan(int line, qint64 &start, qint64 &length) const;
+    QTextLayout * layoutLine(int line);
+    void clearLayouts();
+    void updateGutter();
+    void updateScrollBars();
+    int  visibleLines() const;
+
+private slots:
+    void fileChanged();
+};
+
+#endif // CDCLARGEFILEVIEW_H
@@ -0,0 +1,74 @@
+/**
+  *****************************************************************************
+  *  _____                  ______
+  * /  __ \                 |  _  \
+  * | /  \/_ __ ___  ___ ___| | | |___   ___ ___
+  * | |   | '__/ _ \/ __/ __| | | / _ \ / __/ __|
+  * | \__/\ | | |_| \__ \__ \ |/ / |_| | (__\__ \
+  *  \____/_|  \___/|___/___/___/ \___/ \___|___/
+  *
+  *****************************************************************************
+  *
+  * @file    cdclinenumberpainter.cpp
+  * @author  Martin Vincent Bloedorn
+  * @version V0.1.0
+  * @date    17-October-2026
+  * @brief   Paints line numbers out of pre-rendered digits.
+**/
+
+#include "cdclinenumberpainter.h"
+
+#include <QFontMetrics>
+#include <QtMath>
+
+/**************************************** CONSTRUCTOR *******************************************/
+cdcLineNumberPainter::cdcLineNumberPainter() :
+    digitWidth(0),
+    height(0)
+{
+
+}
+
+/**************************************** METHODS ***********************************************/
+void cdcLineNumberPainter::setFont(const QFont &font) {
+    this->font = font;
+    QFontMetrics metrics(font);
+    digitWidth = metrics.width(QLatin1Char('9'));
+    height     = metrics.height();
+    digitStrip = QPixmap();
+}
+
+int cdcLineNumberPainter::digitsFor(int lineCount) {
+    int digits = 1;
+    for (int max = qMax(1, lineCount); max >= 10; max /= 10)
+        ++digits;
+    return digits;
+}
+
+void cdcLineNumberPainter::drawNumber(QPainter * painter, int right, int top, int number) {
+    qreal ratio = painter->device()->devicePixelRatio();
+    if(digitStrip.isNull() || digitStrip.devicePixelRatio() != ratio)
+        renderDigits(ratio);
+
+    int x = right;
+    do {
+        x -= digitWidth;
+        painter->drawPixmap(QRectF(x, top, digitWidth, height), digitStrip,
+                            QRectF((number % 10) * digitWidth * ratio, 0, digitWidth * ratio, height * ratio));
+        number /= 10;
+    } while(number > 0);
+}
+
+// PRIVATE ------------------------------------------------------------------------
+void cdcLineNumberPainter::renderDigits(qreal ratio) {
+    digitStrip = QPixmap(qCeil(digitWidth * 10 * ratio), qCeil(height * ratio));
+    digitStrip.setDevicePixelRatio(ratio);
+    digitStrip.fill(Qt::transparent);
+
+    QPainter painter(&digitStrip);
+    painter.setFont(font);
+    painter.setPen(Qt::black);
+    for (int digit = 0; digit < 10; ++digit)
+        painter.drawText(QRect(digit * digitWidth, 0, digitWidth, height), Qt::AlignCenter,
+                         QString(QLatin1Char('0' + digit)));
+}
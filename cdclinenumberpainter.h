@@ -0,0 +1,61 @@
+/**
+  *****************************************************************************
+  *  _____                  ______
+  * /  __ \                 |  _  \
+  * | /  \/_ __ ___  ___ ___| | | |___   ___ ___
+  * | |   | '__/ _ \/ __/ __| | | / _ \ / __/ __|
+  * | \__/\ | | |_| \__ \__ \ |/ / |_| | (__\__ \
+  *  \____/_|  \___/|___/___/___/ \___/ \___|___/
+  *
+  *****************************************************************************
+  *
+  * @file    cdclinenumberpainter.h
+  * @author  Martin Vincent Bloedorn
+  * @version V0.1.0
+  * @date    17-October-2026
+  * @brief   Paints line numbers out of pre-rendered digits.
+**/
+
+#ifndef CDCLINENUMBERPAINTER_H
+#define CDCLINENUMBERPAINTER_H
+
+#include <QFont>
+#include <QPixmap>
+#include <QPainter>
+
+/**
+ * @brief Paints the line numbers of a gutter, shared by CodeEditor and cdcLargeFileView .
+ * The digits 0-9 are rendered once, side by side, into a strip; numbers are then blitted from it digit
+ * by digit, right-aligned, instead of being shaped as text on every paint. The strip is rendered again
+ * when the font or the device pixel ratio changes.
+ */
+class cdcLineNumberPainter
+{
+public:
+    cdcLineNumberPainter();
+
+    /// \brief Sets the font numbers are painted with (the one of the text next to the gutter).
+    void setFont(const QFont &font);
+
+    /// \brief Number of digits of the highest line number, for \em lineCount lines.
+    static int digitsFor(int lineCount);
+    /// \brief Width of a gutter fitting numbers of \em digits digits.
+    int widthFor(int digits) { return 3 + digitWidth * digits; }
+
+    /**
+     * @brief Paints \em number right-aligned against \em right , in the row starting at \em top .
+     * The row is as tall as a line of the font.
+     */
+    void drawNumber(QPainter * painter, int right, int top, int number);
+
+private:
+    QFont font;
+    int digitWidth;     /// Width of a digit in font
+    int height;         /// Height of a line in font
+    QPixmap digitStrip; /// Digits 0-9 pre-rendered side by side (null until first painted)
+
+    /// \brief Renders digitStrip with the current font, for a device with \em ratio pixels per point.
+    void renderDigits(qreal ratio);
+};
+
+#endif // CDCLINENUMBERPAINTER_H
@@ -23,15 +23,36 @@ const QString syntaxnameDoxygen   = "Doxygen";
 const QString syntaxnameMarkdown  = "Markdown";
 const QString syntaxnameNone      = "None";
 
+// Idle time after the last edit before the structure of the project is parsed again
+const int reparseDelayMs = 400;
+// Characters of text kept in the documents of input files not shown (layouts and formats come on top)
+const int editorCacheBudget = 16 * 1024 * 1024;
+// Input files bigger than this (in bytes) are shown in the paged, read-only view instead of the editor
+const qint64 largeFileThreshold = 32 * 1024 * 1024;
+
 /**************************************** CONSTRUCTOR *******************************************/
 cdcMainWindow::cdcMainWindow(QWidget *parent) :
     QMainWindow(parent),
+    editorHighlighter(NULL),
     currentDocumentTag(QString::QString("")),
     currentDocumentInputFileIndex(-1),
-    analysisThreshold(0),
+    editorLoading(false),
+    editorSyncedLength(0),
     windowTitle(QString("CrossDocs GUI"))
 {
     pw = new projectWorker();
+    connect(pw, SIGNAL(buildOutput(QString,QString,bool)), this, SLOT(buildOutput(QString,QString,bool)));
+    connect(pw, SIGNAL(buildProgress(int,int)), this, SLOT(buildProgress(int,int)));
+    connect(pw, SIGNAL(buildFinished(bool)), this, SLOT(buildFinished(bool)));
+    connect(pw, SIGNAL(structureUpdated()), this, SLOT(projectStructureUpdated()));
+    connect(pw, SIGNAL(externalChangesDetected()), this, SLOT(externalFilesChanged()));
+    pw->setWatchFiles(true);
+
+    // Restarted on every edit, so a burst of typing ends up in a single reparse
+    reparseTimer = new QTimer(this);
+    reparseTimer->setSingleShot(true);
+    reparseTimer->setInterval(reparseDelayMs);
+    connect(reparseTimer, SIGNAL(timeout()), this, SLOT(updateProjectView()));
 
     this->setAttribute(Qt::WA_QuitOnClose);
 
@@ -43,16 +64,13 @@ cdcMainWindow::cdcMainWindow(QWidget *parent) :
 
     //guiSettings = new QSettings(QSettings::)... no patience for that now
 
-    highlighter = new cdcHighlighter(plainTextEditor->document());
-    highlighter->setSyntax(CDC_fileSyntax::doxygen);
-
     setWindowTitle(windowTitle);
     setUnifiedTitleAndToolBarOnMac(true);
 }
 
 cdcMainWindow::~cdcMainWindow() {
+    clearEditorDocuments();
     delete pw;
-    delete highlighter;
     delete webView;
 }
 
@@ -77,31 +95,53 @@ void cdcMainWindow::menuSyntaxTriggered(QAction *selectedSyntax) {
     else if(selectedSyntax->text().compare(syntaxnameNone)    == 0) newsyntax = CDC_fileSyntax::none;
 
     pw->setDocumentInputFileSyntax(currentDocumentTag, currentDocumentInputFileIndex, newsyntax);
+    if(editorStack->currentWidget() == largeFileView)
+        largeFileView->setSyntax(newsyntax);
 }
 
 void cdcMainWindow::requestBuild() {
     qDebug() << QString(__FUNCTION__) << " Request build";
+    if(pw->startBuild() && pw->isBuilding()) {
+        actionBuild->setEnabled(false);
+        actionCancelBuild->setEnabled(true);
+    }
+}
 
-    QString filename("/Users/martin/Git/provant-software/io-board/stm32f4/app/remote-controlled-flight/doc/html/index.html");
-    QFile file(filename);
+void cdcMainWindow::cancelBuild() {
+    qDebug() << QString(__FUNCTION__) << " Cancel build";
+    pw->cancelBuild();
+}
 
-    if (!file.open(QIODevice::ReadOnly)) {
-        QMessageBox::information(this, tr("Unable to open file"),
-            file.errorString());
-        return;
-    }
+void cdcMainWindow::buildOutput(QString doctag, QString line, bool isError) {
+    logs->append(isError ? QtWarningMsg : QtDebugMsg, "[" + doctag + "] " + line);
+}
 
-    QTextStream out(&file);
-    QString output = out.readAll();
+void cdcMainWindow::buildProgress(int done, int total) {
+    statusBar()->showMessage(tr("Building... %1/%2").arg(done).arg(total));
+}
 
-    // display contents
-    plainTextEditor->setPlainText(output);
-    webView->setHtml(output, QUrl::fromLocalFile(filename));
+void cdcMainWindow::buildFinished(bool ok) {
+    actionBuild->setEnabled(true);
+    actionCancelBuild->setEnabled(false);
+    statusBar()->showMessage(ok ? tr("Build finished") : tr("Build failed"));
+
+    // Show the output of the current document, if any
+    QString index = pw->getDocumentOutputPath(currentDocumentTag) + "html/index.html";
+    if(!currentDocumentTag.isEmpty() && QFile::exists(index))
+        webView->load(QUrl::fromLocalFile(index));
 }
 
 void cdcMainWindow::open() {
     QString fileName = QFileDialog::getOpenFileName(this);
     if (!fileName.isEmpty()) {
+        if(QFileInfo(fileName).size() > largeFileThreshold) { // Never read whole: page it in
+            currentDocumentInputFileIndex = -1;
+            showInputFile();
+            if(largeFileView->openFile(fileName))
+                editorStack->setCurrentWidget(largeFileView);
+            return;
+        }
+
         // read from file
         QFile file(fileName);
 
@@ -114,7 +154,10 @@ void cdcMainWindow::open() {
         QTextStream out(&file);
         QString output = out.readAll();
 
-        // display contents
+        // display contents (detached from the project's input files)
+        currentDocumentInputFileIndex = -1;
+        showInputFile();
+        plainTextEditor->setEnabled(true);
         plainTextEditor->setPlainText(output);
         webView->setHtml(output, QUrl::fromLocalFile(fileName));
     }
@@ -134,6 +177,7 @@ void cdcMainWindow::openProject(QString fileName) {
 }
 
 void cdcMainWindow::loadProject() {
+    clearEditorDocuments(); // buffers (and their revisions) are created anew
     pw->configureProject(currentProjectPath);
 
     currentDocumentInputFileIndex = -1;
@@ -150,81 +194,94 @@ void cdcMainWindow::createNew() {
 
 }
 
-void cdcMainWindow::textEditorChanged() {
-    analysisThreshold++;
-    if(analysisThreshold > 10) {
-        analysisThreshold = 0;
-        updateProjectView();
+void cdcMainWindow::editorContentsChanged(int position, int charsRemoved, int charsAdded) {
+    if(editorLoading || currentDocumentInputFileIndex == -1)
+        return;
+    // Formats applied by the highlighter's own passes leave the text as it is
+    if(charsRemoved == charsAdded && editorHighlighter != NULL && editorHighlighter->isFormatting())
+        return;
+    QTextDocument * doc = plainTextEditor->document();
+    int length = doc->characterCount() - 1; // without the document's last paragraph separator
+
+    // Changes that reach the end of the document may count that separator in
+    int overflow = position + charsAdded - length;
+    if(overflow > 0) {
+        charsAdded   -= overflow;
+        charsRemoved -= overflow;
     }
-}
 
-/**
- * @brief This function is only a helper for the cdcMainWindow::analyseProject() method.
- * It implements recursion over the child elements of itemHandle, expanding them if they were found
- * in the list of previously expanded items ( expandedProjectTreeItems ).
- * Given that the Structural model of the document IS bounded, this function will always return.
- */
-void recursiveItemExpansion(QStandardItem * itemHandle, QStringList taglist, QTreeView * treeView) {
-    for (int i = 0; i < itemHandle->rowCount(); ++i) {
-        if(taglist.lastIndexOf(itemHandle->child(i)->data(CDC_docStructuralElementRole::Tag).toString()) != -1)
-            treeView->expand(itemHandle->child(i)->index());
-        if(itemHandle->child(i)->hasChildren())
-            recursiveItemExpansion(itemHandle->child(i), taglist, treeView);
+    int revision = pw->getInputFileRevision(currentEditorKey);
+    CDC_status st = CDC_status::paramError;
+    if(charsRemoved >= 0 && editorSyncedLength - charsRemoved + charsAdded == length) {
+        QString added;
+        if(charsAdded > 0) {
+            QTextCursor cursor(doc);
+            cursor.setPosition(position);
+            cursor.setPosition(position + charsAdded, QTextCursor::KeepAnchor);
+            added = cursor.selectedText().replace(QChar::ParagraphSeparator, QLatin1Char('\n'));
+        }
+        pw->editDocumentInputFileContents(currentDocumentTag, currentDocumentInputFileIndex,
+                                          position, charsRemoved, added, &st);
+    }
+    if(st != CDC_status::ok) { // Out of step with the buffer (should not happen): push the whole text once
+        qWarning() << QString(__FUNCTION__) << "Editor out of sync, reloading buffer from the editor";
+        pw->setDocumentInputFileContents(currentDocumentTag, currentDocumentInputFileIndex, plainTextEditor->toPlainText());
     }
+    editorSyncedLength = length;
+    // Reformatted blocks come through here too: they are no-ops for the buffer, and don't need a reparse
+    if(pw->getInputFileRevision(currentEditorKey) != revision)
+        reparseTimer->start();
 }
 
 void cdcMainWindow::updateProjectView() {
-    pw->setDocumentInputFileContents(currentDocumentTag, currentDocumentInputFileIndex, plainTextEditor->toPlainText());
-
-    treeProject->setModel(pw->getProjectStructure());
+    // Parsed in the background; the tree is updated in projectStructureUpdated()
+    pw->requestStructureUpdate();
+}
 
-    QStandardItem * itemHandle;
-    QString currdoc;
-    QString itemtag;
-    QStringList currtags;
-    for (int i = 0; i < treeProject->model()->rowCount(); ++i) { // Iterate over all docs
-        itemHandle = dynamic_cast<QStandardItemModel *>(treeProject->model())->item(i);
-        itemtag    = itemHandle->data(CDC_docStructuralElementRole::Tag).toString();
-        currdoc    = itemHandle->data(CDC_docStructuralElementRole::Doc).toString();
-        for (int j = 0; j < expandedProjectTreeItems.length(); ++j) { // Go through the list of items that were expanded
-            if(expandedProjectTreeItems[j].doc.compare(currdoc) == 0) {
-                currtags = expandedProjectTreeItems[j].tags;
-                if(currtags.lastIndexOf(itemtag) != -1) // Expand document if needed
-                    treeProject->expand(itemHandle->index());
-                recursiveItemExpansion(itemHandle, currtags, treeProject); // Check 'n expand doc's elements
-            }
+void cdcMainWindow::externalFilesChanged() {
+    QStringList reloaded;
+    if(pw->applyExternalChanges(&reloaded)) {
+        if(!pw->hasUnsavedChanges()) {
+            qDebug() << QString(__FUNCTION__) << "Project configuration changed on disk, reloading";
+            loadProject();
+            return;
         }
+        qWarning() << QString(__FUNCTION__) << "Project configuration changed on disk."
+                   << "Save your changes and reopen the project to apply it.";
     }
-}
 
-void cdcMainWindow::projectTreeItemExpanded(QModelIndex index) {
-    QString tag = treeProject->model()->data(index, CDC_docStructuralElementRole::Tag).toString();
-    QString doc = treeProject->model()->data(index, CDC_docStructuralElementRole::Doc).toString();
-    for(int i = 0; i < expandedProjectTreeItems.length(); ++i) {
-       if(expandedProjectTreeItems[i].doc.compare(doc) == 0) {
-           if(expandedProjectTreeItems[i].tags.lastIndexOf(tag) == -1) {
-               expandedProjectTreeItems[i].tags.append(tag);
-               //qDebug() << "Appended " << tag << " to document " << doc;
-           }
-           return;
-       }
-    }
-    treeProjectDocExpTags texp;
-    texp.doc = doc; texp.tags.append(tag);
-    expandedProjectTreeItems.append(texp);
-    //qDebug() << "Appended " << tag << " to NEWLY created document entry, " << doc;
-}
-
-void cdcMainWindow::projectTreeItemCollapsed(QModelIndex index) {
-    QString tag = treeProject->model()->data(index, CDC_docStructuralElementRole::Tag).toString();
-    QString doc = treeProject->model()->data(index, CDC_docStructuralElementRole::Doc).toString();
-    for(int i = 0; i < expandedProjectTreeItems.length(); ++i) {
-       if(expandedProjectTreeItems[i].doc.compare(doc) == 0) {
-           expandedProjectTreeItems[i].tags.removeAll(tag);
-           qDebug() << "Removed " << tag << " in document " << doc;
-           return;
-       }
+    // Show the new contents if the file being edited was reloaded, keeping the cursor's line
+    if(currentDocumentInputFileIndex == -1)
+        return;
+    QString currentPath = pw->getDocumentInputFilesList(currentDocumentTag).value(currentDocumentInputFileIndex);
+    if(!reloaded.contains(currentPath))
+        return;
+    if(editorStack->currentWidget() == largeFileView) {
+        largeFileView->reload();
+        qDebug() << QString(__FUNCTION__) << "Reloaded" << currentPath;
+        return;
     }
+    int line = plainTextEditor->textCursor().blockNumber();
+    reloadInputFile();
+    QTextCursor cursor = plainTextEditor->textCursor();
+    cursor.movePosition(QTextCursor::Start);
+    cursor.movePosition(QTextCursor::Down, QTextCursor::MoveAnchor, line);
+    plainTextEditor->setTextCursor(cursor);
+    qDebug() << QString(__FUNCTION__) << "Reloaded" << currentPath;
+}
+
+void cdcMainWindow::saveAll() {
+    CDC_status st = CDC_status::ok;
+    int saved = pw->saveAllInputFiles(&st);
+    if(st != CDC_status::ok)
+        qWarning() << QString(__FUNCTION__) << "Some files could not be saved; they keep their unsaved modifications.";
+    statusBar()->showMessage(tr("Saved %n file(s)", "", saved), 3000);
+}
+
+void cdcMainWindow::projectStructureUpdated() {
+    // The model is updated in place with only what changed, so the view keeps its expanded
+    // items, selection and scroll position
+    pw->getProjectStructure();
 }
 
 void cdcMainWindow::projectTreeItemSelected(QModelIndex index) {
@@ -237,10 +294,6 @@ void cdcMainWindow::projectTreeItemSelected(QModelIndex index) {
     CDC_docStructuralElementType type = static_cast<CDC_docStructuralElementType>
             (treeProject->model()->data(index, CDC_docStructuralElementRole::Type).toInt());
 
-    // Store the contents of current text being edited. Though you may not be changing files, saving the contents
-    // here makes the logic of the switching soooo much more readable, at (theoretically) almost no cost (assign a variable)
-    pw->setDocumentInputFileContents(currentDocumentTag, currentDocumentInputFileIndex, plainTextEditor->toPlainText());
-
     if(type == CDC_docStructuralElementType::document) {
         if(selectedTag.compare(currentDocumentTag) != 0) { // Selected a different doc!
             listFilesWidget->clear();
@@ -259,11 +312,11 @@ void cdcMainWindow::projectTreeItemSelected(QModelIndex index) {
             currentDocumentInputFileIndex = 0;
             listFilesWidget->setCurrentRow(0);
             plainTextEditor->setEnabled(true);
-            plainTextEditor->setText(pw->getDocumentInputFileContents(selectedTag, 0));
+            showInputFile();
             updateSyntaxMenu(pw->getDocumentInputFileSyntax(selectedTag,0));
         }
         else {
-            plainTextEditor->setText(QString(""));
+            showInputFile();
             plainTextEditor->setEnabled(false);
             return;
         }
@@ -286,15 +339,20 @@ void cdcMainWindow::projectTreeItemSelected(QModelIndex index) {
             currentDocumentInputFileIndex = selectedIndex;
             listFilesWidget->setCurrentRow(selectedIndex);
             plainTextEditor->setEnabled(true);
-            plainTextEditor->setText(pw->getDocumentInputFileContents(selectedDoc, selectedIndex));
+            showInputFile();
             updateSyntaxMenu(pw->getDocumentInputFileSyntax(selectedDoc,selectedIndex));
         }
         else {
-            plainTextEditor->setText(QString(""));
+            showInputFile();
             plainTextEditor->setEnabled(false);
             return;
         }
 
+        if(editorStack->currentWidget() == largeFileView) {
+            largeFileView->setFocus();
+            largeFileView->goToLine(line-1);
+            return;
+        }
         plainTextEditor->setEnabled(true);
         plainTextEditor->setFocus();
         QTextCursor cursor = plainTextEditor->textCursor();  // Now move the cursor to the desired line
@@ -307,9 +365,8 @@ void cdcMainWindow::projectTreeItemSelected(QModelIndex index) {
 void cdcMainWindow::listFilesWidgetSelected() {
     int index = listFilesWidget->currentRow();
     if(index != currentDocumentInputFileIndex) {
-        pw->setDocumentInputFileContents(currentDocumentTag, currentDocumentInputFileIndex, plainTextEditor->toPlainText());
         currentDocumentInputFileIndex = index;
-        plainTextEditor->setText(pw->getDocumentInputFileContents(currentDocumentTag, index));
+        showInputFile();
     }
 }
 
@@ -325,30 +382,160 @@ void cdcMainWindow::messageHandler(QtMsgType type, const char *msg, bool isDialo
         }
     }
     else
-    {
-        switch (type) {
-            case QtDebugMsg:
-                logArea->setTextColor(Qt::black);
-                logArea->append(QString(QDateTime::currentDateTime().toString("hh.mm.ss.zzz") + ": " + msg));
-                break;
-            case QtWarningMsg:
-                logArea->setTextColor(QColor(255,150,0));
-                logArea->append(QString(QDateTime::currentDateTime().toString("hh.mm.ss.zzz") + ": " + msg));
-                break;
-            case QtCriticalMsg:
-                logArea->setTextColor(Qt::red);
-                logArea->append(QString(QDateTime::currentDateTime().toString("hh.mm.ss.zzz") + ": " + msg));
-                break;
-            case QtFatalMsg:
-                logArea->setTextColor(Qt::red);
-                logArea->append(QString(QDateTime::currentDateTime().toString("hh.mm.ss.zzz") + " FATAL: " + msg));
-            break;
-        }
-    }
-    logArea->moveCursor(QTextCursor::End);
+        logs->append(type, QString::fromLocal8Bit(msg));
+}
+
+void cdcMainWindow::logMessage(int type, QString msg) {
+    logs->append(static_cast<QtMsgType>(type), msg);
+}
+
+void cdcMainWindow::logSeverityChanged(int index) {
+    logs->setMinimumSeverity(static_cast<QtMsgType>(logSeverityCombo->itemData(index).toInt()));
+    logView->scrollToBottom();
+}
+
+void cdcMainWindow::logRetentionChanged(int value) {
+    logs->setRetention(value);
+    logView->scrollToBottom();
+}
+
+void cdcMainWindow::logRowsAboutToBeInserted() {
+    QScrollBar * bar = logView->verticalScrollBar();
+    logFollowTail = bar->value() == bar->maximum();
+}
+
+void cdcMainWindow::logRowsInserted() {
+    if(logFollowTail)
+        logView->scrollToBottom();
+}
+
+void cdcMainWindow::copyLogSelection() {
+    QModelIndexList selected = logView->selectionModel()->selectedRows();
+    qSort(selected);
+    QStringList lines;
+    for (int i = 0; i < selected.length(); ++i)
+        lines.append(selected[i].data().toString());
+    QApplication::clipboard()->setText(lines.join("\n"));
 }
 
 // PRIVATE ------------------------------------------------------------------------
+void cdcMainWindow::showInputFile() {
+    // Keep the state of the file being hidden
+    if(editorStack->currentWidget() == plainTextEditor && editorDocuments.contains(currentEditorKey)) {
+        CDC_editorDocument &shown = editorDocuments[currentEditorKey];
+        shown.cursor   = plainTextEditor->textCursor();
+        shown.scroll   = plainTextEditor->verticalScrollBar()->value();
+        shown.revision = pw->getInputFileRevision(currentEditorKey);
+    }
+
+    if(currentDocumentInputFileIndex == -1) {
+        currentEditorKey.clear();
+        setEditorDocument(emptyEditorDocument, NULL);
+        // Drop whatever was shown there last (e.g. a loose file from open() ) and its undo history
+        editorLoading = true;
+        emptyEditorDocument->clear();
+        editorLoading = false;
+        largeFileView->closeFile();
+        editorStack->setCurrentWidget(plainTextEditor);
+        return;
+    }
+
+    QString key = pw->getDocumentInputFilesList(currentDocumentTag).value(currentDocumentInputFileIndex);
+    if(QFileInfo(key).size() > largeFileThreshold) {
+        currentEditorKey = key; // not in editorDocuments: nothing to keep when hidden
+        setEditorDocument(emptyEditorDocument, NULL);
+        // Indexed again only when coming from another file (it may have changed meanwhile)
+        if(editorStack->currentWidget() != largeFileView || largeFileView->getFilePath() != key)
+            largeFileView->openFile(key);
+        largeFileView->setSyntax(pw->getDocumentInputFileSyntax(currentDocumentTag, currentDocumentInputFileIndex));
+        editorStack->setCurrentWidget(largeFileView);
+        statusBar()->showMessage(tr("Large file: shown read-only"), 3000);
+        return;
+    }
+    largeFileView->closeFile();
+    editorStack->setCurrentWidget(plainTextEditor);
+    if(!editorDocuments.contains(key)) {
+        CDC_editorDocument entry;
+        entry.document = new QTextDocument(this);
+        entry.document->setDocumentLayout(new QPlainTextDocumentLayout(entry.document));
+        entry.document->setDefaultFont(plainTextEditor->font());
+        entry.highlighter = new cdcHighlighter(entry.document);
+        entry.highlighter->setSyntax(CDC_fileSyntax::doxygen);
+        entry.scroll   = 0;
+        entry.revision = -1; // loaded below
+        editorDocuments.insert(key, entry);
+    }
+    else
+        editorDocumentsLru.removeOne(key);
+    editorDocumentsLru.append(key);
+
+    currentEditorKey = key;
+    const CDC_editorDocument &entry = editorDocuments[key];
+    setEditorDocument(entry.document, entry.highlighter);
+    if(entry.revision != pw->getInputFileRevision(key))
+        reloadInputFile(); // New, or changed while hidden
+    else {
+        plainTextEditor->setTextCursor(entry.cursor);
+        plainTextEditor->verticalScrollBar()->setValue(entry.scroll);
+        editorSyncedLength = entry.document->characterCount() - 1;
+    }
+    trimEditorDocuments();
+}
+
+void cdcMainWindow::reloadInputFile() {
+    CDC_editorDocument &entry = editorDocuments[currentEditorKey];
+    QString contents = pw->getDocumentInputFileContents(currentDocumentTag, currentDocumentInputFileIndex);
+    editorLoading = true;
+    entry.document->setPlainText(contents);
+    editorLoading = false;
+    entry.revision = pw->getInputFileRevision(currentEditorKey);
+    editorSyncedLength = entry.document->characterCount() - 1;
+
+    // setPlainText() may normalize some characters (e.g. line endings): keep the buffer as shown
+    if(editorSyncedLength != contents.length())
+        pw->setDocumentInputFileContents(currentDocumentTag, currentDocumentInputFileIndex, plainTextEditor->toPlainText());
+}
+
+void cdcMainWindow::setEditorDocument(QTextDocument * document, cdcHighlighter * highlighter) {
+    QTextDocument * previous = plainTextEditor->document();
+    if(previous == document)
+        return;
+    // Only the document in the editor is followed: hidden ones still get format-only changes from their highlighters
+    disconnect(previous, SIGNAL(contentsChange(int,int,int)), this, SLOT(editorContentsChanged(int,int,int)));
+    disconnect(plainTextEditor, SIGNAL(visibleBlocksChanged(int,int)), 0, 0);
+
+    editorLoading = true;
+    plainTextEditor->swapDocument(document);
+    editorLoading = false;
+
+    connect(document, SIGNAL(contentsChange(int,int,int)), this, SLOT(editorContentsChanged(int,int,int)));
+    editorHighlighter = highlighter;
+    if(highlighter != NULL)
+        connect(plainTextEditor, SIGNAL(visibleBlocksChanged(int,int)), highlighter, SLOT(setVisibleBlocks(int,int)));
+}
+
+void cdcMainWindow::trimEditorDocuments() {
+    qint64 total = 0;
+    for (int i = 0; i < editorDocumentsLru.length(); ++i)
+        total += editorDocuments[editorDocumentsLru[i]].document->characterCount();
+    // The last one is the document in the editor, which always stays
+    while(editorDocumentsLru.length() > 1 && total > editorCacheBudget) {
+        CDC_editorDocument entry = editorDocuments.take(editorDocumentsLru.takeFirst());
+        total -= entry.document->characterCount();
+        delete entry.document; // and its highlighter
+    }
+}
+
+void cdcMainWindow::clearEditorDocuments() {
+    currentEditorKey.clear();
+    setEditorDocument(emptyEditorDocument, NULL);
+    QHash<QString, CDC_editorDocument>::iterator it;
+    for (it = editorDocuments.begin(); it != editorDocuments.end(); ++it)
+        delete it.value().document;
+    editorDocuments.clear();
+    editorDocumentsLru.clear();
+}
+
 void cdcMainWindow::updateSyntaxMenu(CDC_fileSyntax syntax) {
     QString syntaxname;
     switch (syntax) {
@@ -380,11 +567,21 @@ void cdcMainWindow::createActions()
     actionBuild->setStatusTip(tr("Build current document"));
     connect(actionBuild, SIGNAL(triggered()), this, SLOT(requestBuild()));
 
+    actionCancelBuild = new QAction(QIcon(":/icons/gnomesubtract.png"), tr("&Cancel Build"), this);
+    actionCancelBuild->setStatusTip(tr("Cancel the running build"));
+    actionCancelBuild->setEnabled(false);
+    connect(actionCancelBuild, SIGNAL(triggered()), this, SLOT(cancelBuild()));
+
     actionNew = new QAction(QIcon(":/icons/new_star.png"), tr("&New..."), this);
     actionNew->setShortcuts(QKeySequence::New);
     actionNew->setStatusTip(tr("Create new document/project"));
     connect(actionNew, SIGNAL(triggered()), this, SLOT(createNew()));
 
+    actionSaveAll = new QAction(QIcon(":/icons/save.png"), tr("&Save All"), this);
+    actionSaveAll->setShortcuts(QKeySequence::Save);
+    actionSaveAll->setStatusTip(tr("Save all modified files of the project"));
+    connect(actionSaveAll, SIGNAL(triggered()), this, SLOT(saveAll()));
+
     actionOpen = new QAction(QIcon(":/icons/open.png"), tr("&Open"), this);
     actionOpen->setShortcuts(QKeySequence::Open);
     actionOpen->setStatusTip(tr("Open a file"));
@@ -419,10 +616,12 @@ void cdcMainWindow::createMenus() {
     menuFile = menuBar()->addMenu(tr("&File"));
     menuFile->addAction(actionNew);
     menuFile->addAction(actionOpenProject);
+    menuFile->addAction(actionSaveAll);
     menuFile->addAction(actionExit);
 
     menuEdit = menuBar()->addMenu(tr("&Tools"));
     menuEdit->addAction(actionBuild);
+    menuEdit->addAction(actionCancelBuild);
     menuEdit->addAction(actionPreferences);
 
     actionsSyntaxList = new QActionGroup(this);
@@ -454,7 +653,9 @@ void cdcMainWindow::createToolbars()
     toolbarFile = addToolBar(tr("Toolbar"));
     toolbarFile->addAction(actionNew);
     toolbarFile->addAction(actionOpenProject);
+    toolbarFile->addAction(actionSaveAll);
     toolbarFile->addAction(actionBuild);
+    toolbarFile->addAction(actionCancelBuild);
     toolbarFile->addAction(actionPreferences);
     toolbarFile->addAction(actionToggleFullscreen);
     toolbarFile->addAction(actionExit);
@@ -469,7 +670,12 @@ void cdcMainWindow::createStatusBar()
 void cdcMainWindow::createWidgets()
 {
     plainTextEditor     = new CodeEditor(this);
-    logArea             = new QTextEdit(this);
+    largeFileView       = new cdcLargeFileView(this);
+    editorStack         = new QStackedWidget(this);
+    logs                = new logModel(this);
+    logView             = new QListView(this);
+    logSeverityCombo    = new QComboBox(this);
+    logRetentionSpin    = new QSpinBox(this);
     treeProject         = new QTreeView(this);
     listFilesWidget     = new QListWidget(this);
     webView             = new QWebView(this);
@@ -479,10 +685,43 @@ void cdcMainWindow::createWidgets()
     plainTextEditor->setFont(*font);
     plainTextEditor->resize(fm->width(".")*160, plainTextEditor->height()); //160 chars width
     plainTextEditor->setLineWrapMode(QPlainTextEdit::NoWrap);
-
-    logArea->setTextInteractionFlags(Qt::TextSelectableByMouse);
-    logArea->setFocusPolicy(Qt::NoFocus);
-    logArea->setFont(QFont("Courier"));
+    largeFileView->setFont(*font);
+    editorStack->addWidget(plainTextEditor);
+    editorStack->addWidget(largeFileView);
+
+    // The editor's own document would be deleted when swapped out: start with one of ours instead
+    emptyEditorDocument = new QTextDocument(this);
+    emptyEditorDocument->setDocumentLayout(new QPlainTextDocumentLayout(emptyEditorDocument));
+    emptyEditorDocument->setDefaultFont(*font);
+    setEditorDocument(emptyEditorDocument, NULL);
+
+    // Every row is one line of the same font: uniform sizes let the view skip measuring them
+    logView->setModel(logs);
+    logView->setUniformItemSizes(true);
+    logView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    logView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    logView->setFocusPolicy(Qt::ClickFocus);
+    logView->setFont(QFont("Courier"));
+    logFollowTail = true;
+
+    QAction * actionCopyLog = new QAction(tr("&Copy"), logView);
+    actionCopyLog->setShortcuts(QKeySequence::Copy);
+    actionCopyLog->setShortcutContext(Qt::WidgetShortcut);
+    connect(actionCopyLog, SIGNAL(triggered()), this, SLOT(copyLogSelection()));
+    QAction * actionClearLog = new QAction(tr("C&lear"), logView);
+    connect(actionClearLog, SIGNAL(triggered()), logs, SLOT(clear()));
+    logView->addAction(actionCopyLog);
+    logView->addAction(actionClearLog);
+    logView->setContextMenuPolicy(Qt::ActionsContextMenu);
+
+    logSeverityCombo->addItem(tr("All messages"), static_cast<int>(QtDebugMsg));
+    logSeverityCombo->addItem(tr("Warnings"),     static_cast<int>(QtWarningMsg));
+    logSeverityCombo->addItem(tr("Errors"),       static_cast<int>(QtCriticalMsg));
+    logRetentionSpin->setRange(100, 1000000);
+    logRetentionSpin->setSingleStep(1000);
+    logRetentionSpin->setValue(logs->getRetention());
+    logRetentionSpin->setSuffix(tr(" messages"));
+    logRetentionSpin->setToolTip(tr("Older messages are dropped"));
 
     listFilesWidget->setAlternatingRowColors(true);
 
@@ -499,6 +738,10 @@ void cdcMainWindow::createWidgets()
     QGroupBox   *hSidePanel       = new QGroupBox(this);
     QVBoxLayout *hSideLayout      = new QVBoxLayout(this);
 
+    QWidget     *logPanel         = new QWidget(this);
+    QVBoxLayout *logLayout        = new QVBoxLayout(logPanel);
+    QHBoxLayout *logOptionsLayout = new QHBoxLayout();
+
     QString string = "<html><body><h1>Welcome to CrossDocs GUI!</h1>"
                      " <p>Type in your text on the left pane and click"
                      " build to generate your documentation!</p>"
@@ -512,14 +755,23 @@ void cdcMainWindow::createWidgets()
     hSideLayout->addWidget(dockFiles);
     hSidePanel->setLayout(hSideLayout);
 
-    vCentralSplitter->addWidget(plainTextEditor);
+    logOptionsLayout->addWidget(new QLabel(tr("Show:"), logPanel));
+    logOptionsLayout->addWidget(logSeverityCombo);
+    logOptionsLayout->addWidget(new QLabel(tr("Keep:"), logPanel));
+    logOptionsLayout->addWidget(logRetentionSpin);
+    logOptionsLayout->addStretch();
+    logLayout->setContentsMargins(0, 0, 0, 0);
+    logLayout->addLayout(logOptionsLayout);
+    logLayout->addWidget(logView);
+
+    vCentralSplitter->addWidget(editorStack);
     vCentralSplitter->addWidget(webView);
     hCentralLayout->addWidget(vCentralSplitter);
     hCentralPanel->setLayout(hCentralLayout);
 
     hCentralSplitter->setOrientation(Qt::Vertical);
     hCentralSplitter->addWidget(hCentralPanel);
-    hCentralSplitter->addWidget(logArea);
+    hCentralSplitter->addWidget(logPanel);
 
     vSideSplitter->addWidget(hSidePanel);
     vSideSplitter->addWidget(hCentralSplitter);
@@ -530,10 +782,11 @@ void cdcMainWindow::createWidgets()
     menuView->addAction(dockStructure->toggleViewAction());
 
     connect(treeProject, SIGNAL(doubleClicked(QModelIndex)), this, SLOT(projectTreeItemSelected(QModelIndex)));
-    connect(treeProject, SIGNAL(expanded(QModelIndex)), this, SLOT(projectTreeItemExpanded(QModelIndex)));
-    connect(treeProject, SIGNAL(collapsed(QModelIndex)), this, SLOT(projectTreeItemCollapsed(QModelIndex)));
     connect(listFilesWidget, SIGNAL(itemDoubleClicked(QListWidgetItem*)), this, SLOT(listFilesWidgetSelected()));
-    connect(plainTextEditor, SIGNAL(textChanged()), this, SLOT(textEditorChanged()));
+    connect(logs, SIGNAL(rowsAboutToBeInserted(QModelIndex,int,int)), this, SLOT(logRowsAboutToBeInserted()));
+    connect(logs, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(logRowsInserted()));
+    connect(logSeverityCombo, SIGNAL(currentIndexChanged(int)), this, SLOT(logSeverityChanged(int)));
+    connect(logRetentionSpin, SIGNAL(valueChanged(int)), this, SLOT(logRetentionChanged(int)));
 
     connect(new QShortcut(QKeySequence::Undo, this), SIGNAL(activated()), plainTextEditor, SLOT(undo()));
     connect(new QShortcut(QKeySequence::Redo, this), SIGNAL(activated()), plainTextEditor, SLOT(redo()));
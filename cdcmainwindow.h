@@ -22,7 +22,7 @@
   *       the tree if a SE keyword match occurs.
   * \todo Add suport to open the last opened projects
   * \todo IMPORTANT: when cdd parsing fail, the tree shows up with a blank element. Create some 'isOk' in documentWorker
-  * \todo VERY IMPORTANT: When a IF isnt modified, it should not be reparsed for its structure!
+  * \todo \b DONE! VERY IMPORTANT: When a IF isnt modified, it should not be reparsed for its structure!
 **/
 
 #ifndef MAINWINDOW_H
@@ -39,6 +39,8 @@
 #include "projectworker.h"
 #include "cdchighlighter.h"
 #include "cdccodeeditor.h"
+#include "cdclargefileview.h"
+#include "logmodel.h"
 
 class cdcMainWindow : public QMainWindow
 {
@@ -52,6 +54,8 @@ signals:
 
 public slots: 
     void messageHandler(QtMsgType type, const char *msg, bool isDialog);
+    /// \brief Adds a message to the log console. Thread-safe: can be called from any thread.
+    void logMessage(int type, QString msg);
     void openProject(QString fileName = QString::QString(""));
 
 private slots:
@@ -59,11 +63,44 @@ private slots:
     void menuSyntaxTriggered(QAction * selectedSyntax);
     void toggleFullscreen(bool);
     void requestBuild();
+    void cancelBuild();
+    void buildOutput(QString doctag, QString line, bool isError);
+    void buildProgress(int done, int total);
+    void buildFinished(bool ok);
     void open();
     void loadProject();
     void createNew();
-    void textEditorChanged();
+
+    /**
+     * @brief Applies one change of the editor's document to the input file being edited.
+     * Connected to \b QTextDocument::contentsChange , so the project's buffer is always in step with the
+     * editor and never has to be refreshed with a copy of the whole text. Format-only changes (from the
+     * highlighter) are ignored; actual edits restart reparseTimer .
+     */
+    void editorContentsChanged(int position, int charsRemoved, int charsAdded);
     void updateProjectView();
+    void projectStructureUpdated();
+
+    /**
+     * @brief Applies changes made to the project's files outside CrossDocs (see projectWorker::applyExternalChanges() ).
+     * The file being edited is reloaded only if it has no unsaved modifications; if the cdc or a cdd file
+     * changed, the project is reloaded as long as nothing would be lost.
+     */
+    void externalFilesChanged();
+
+    /**
+     * @brief Saves every modified input file at once (see projectWorker::saveAllInputFiles() ).
+     * Edits reach the buffers as they are made (see editorContentsChanged() ), so nothing has to be
+     * pushed from the editor first.
+     */
+    void saveAll();
+
+    void logSeverityChanged(int index);
+    void logRetentionChanged(int value);
+    void logRowsAboutToBeInserted();
+    /// \brief Keeps the log console scrolled to the newest message, unless the user scrolled away from it.
+    void logRowsInserted();
+    void copyLogSelection();
 
     /**
      * @brief Implements the behavior when an object on the structure tree is selected.
@@ -77,9 +114,6 @@ private slots:
      */
     void projectTreeItemSelected(QModelIndex  index);
 
-    void projectTreeItemExpanded(QModelIndex  index);
-    void projectTreeItemCollapsed(QModelIndex index);
-
     void listFilesWidgetSelected();//QTreeWidgetItem* item);
 
 private:
@@ -91,29 +125,62 @@ private:
 
     void updateSyntaxMenu(CDC_fileSyntax syntax);
 
+    /**
+     * @brief Shows the current input file (currentDocumentTag , currentDocumentInputFileIndex ) in the editor.
+     * Every input file shown gets its own \b QTextDocument (and highlighter), which is kept and swapped back
+     * in the next time, with its undo history, cursor and scroll position. Documents whose buffer changed
+     * while hidden (e.g. reloaded from disk) are loaded again. The least recently shown documents are
+     * dropped once their text exceeds a budget.
+     * Input files bigger than largeFileThreshold are never loaded into a document: they are shown,
+     * read-only, in largeFileView , which pages them in from disk.
+     */
+    void showInputFile();
+
+    /// \brief Loads the buffer of the current input file into its document again (drops its undo history).
+    void reloadInputFile();
+
+    void setEditorDocument(QTextDocument * document, cdcHighlighter * highlighter);
+    void trimEditorDocuments();
+    void clearEditorDocuments();
+
     projectWorker * pw;
-    cdcHighlighter * highlighter;
+
+    /// \brief Editor state of an input file that is (or was recently) shown. See showInputFile() .
+    typedef struct {
+        QTextDocument * document;   /// Parent of highlighter
+        cdcHighlighter * highlighter;
+        QTextCursor cursor;         /// Cursor when the document was last hidden
+        int scroll;                 /// Vertical scroll position when the document was last hidden
+        int revision;               /// Buffer revision the document was last in step with
+    } CDC_editorDocument;
+
+    QHash<QString, CDC_editorDocument> editorDocuments; /// By canonical input file path
+    QStringList editorDocumentsLru;         /// Keys of editorDocuments, least recently shown first
+    QString currentEditorKey;               /// Key of the document in the editor (empty if none)
+    cdcHighlighter * editorHighlighter;     /// Highlighter of the document in the editor (NULL if none)
+    QTextDocument * emptyEditorDocument;    /// Shown when no input file is selected
 
 
     QString currentProjectPath;
     QString currentDocumentTag;
     int     currentDocumentInputFileIndex;
 
-    /// Holds the tags of the expanded SEs of a document in the treeProject view
-    typedef struct {
-        QString     doc;
-        QStringList tags;
-    } treeProjectDocExpTags;
-    QList<treeProjectDocExpTags> expandedProjectTreeItems;
-
-    int     analysisThreshold;
+    QTimer  *reparseTimer;    /// Debounces structure updates while the user types
+    bool    editorLoading;    /// The editor's contents are being replaced: not an edit
+    int     editorSyncedLength; /// Length of the current input file's buffer, as far as the editor knows
 
 /***    GUI ELEMENTS   *******************************************/
     CodeEditor  *plainTextEditor;
+    cdcLargeFileView *largeFileView;
+    QStackedWidget *editorStack;    /// Shows either plainTextEditor or largeFileView
     QSettings   *guiSettings;
     QString     windowTitle;
     QToolBar    *toolbarFile;
-    QTextEdit   *logArea;
+    logModel    *logs;
+    QListView   *logView;
+    QComboBox   *logSeverityCombo;
+    QSpinBox    *logRetentionSpin;
+    bool        logFollowTail;  /// Whether logView was at the newest message before the last insertion
     QListWidget *listFilesWidget;
     QWebView    *webView;
     QTreeView   *treeProject;
@@ -127,7 +194,9 @@ private:
     QAction     *actionOpen;
     QAction     *actionOpenProject;
     QAction     *actionNew;
+    QAction     *actionSaveAll;
     QAction     *actionBuild;
+    QAction     *actionCancelBuild;
     QAction     *actionTest;
     QAction     *actionAbout;
     QAction     *actionAboutQt;
@@ -22,137 +22,155 @@
 
 enum class CDC_cState {idle, at_header, at_argument, fail};
 
+/// Spans of the (space-separated) tokens of a line that matter to the FSM. Offsets are relative to the buffer.
+typedef struct {
+    int count;          /// Number of tokens, saturated at 2
+    qint64 start;       /// First token
+    qint64 end;
+    qint64 nextStart;   /// Second token (if count == 2)
+} CDC_cLineTokens;
+
+/* Local functions ----------------------------------------------------------*/
+
+/// \brief Finds the first two tokens of the line [start, end). Tokens are separated by spaces only.
+static void tokenizeLine(const char * data, qint64 start, qint64 end, CDC_cLineTokens &tokens) {
+    qint64 pos = start;
+    tokens.count = 0;
+    while(pos < end && data[pos] == ' ') pos++;
+    if(pos == end)
+        return;
+    tokens.count = 1;
+    tokens.start = pos;
+    while(pos < end && data[pos] != ' ') pos++;
+    tokens.end = pos;
+    while(pos < end && data[pos] == ' ') pos++;
+    if(pos < end) {
+        tokens.count     = 2;
+        tokens.nextStart = pos;
+    }
+}
+
 /* Constructor & Destructor -------------------------------------------------*/
 
-configurationFileParser::configurationFileParser() {}
+configurationFileParser::configurationFileParser() :
+    errorLine(0),
+    errorColumn(0)
+{}
 
 configurationFileParser::~configurationFileParser() {}
 
 /* Public methods -----------------------------------------------------------*/
 
 bool configurationFileParser::parseFile(QString fpath, CDC_status * retStatus) {
-    // Preamble --------------------
-    bool retval = true;
-    bool skip = false;
-    int currLine = 0;
-    QString line;
-    QStringList lsplit;
-    CDC_cState state = CDC_cState::idle;
-
     // Clear previous contents, that might be related to other file.
     confFileSections.clear();
+    sectionHeaders.clear();
+    sectionIndex.clear();
+    errorLine   = 0;
+    errorColumn = 0;
 
-    // Body ------------------------
-
-    // Open file
-    file = new QFile(fpath);
-    if(!file->open(QIODevice::ReadOnly)) {
+    QFile file(fpath);
+    if(!file.open(QIODevice::ReadOnly)) {
         qDebug() << QString(__FUNCTION__) << " Could not open " << fpath;
-        retval = false;
         if(retStatus != NULL)
             *retStatus = CDC_status::ioError;
+        return false;
+    }
+    // The whole file goes into one buffer, reused from call to call
+    qint64 length = file.size();
+    buffer.resize(static_cast<int>(length));
+    length = file.read(buffer.data(), length);
+    file.close();
+    if(length < 0) {
+        qDebug() << QString(__FUNCTION__) << " Could not read " << fpath;
+        if(retStatus != NULL)
+            *retStatus = CDC_status::ioError;
+        return false;
     }
 
-    // Text stream
-    fileIn = new QTextStream(file);
-
-    /// Finite state machine
-    while(!fileIn->atEnd()) {
-        currLine++;
-        line = fileIn->readLine();
-        lsplit = line.split(" ", QString::SkipEmptyParts);
-
-        // Check state transition, according to current state
-        if(state == CDC_cState::idle && !skip) {
-            state = CDC_cState::fail; // defaults to 'fail' if no transition below happens
-
-            if(lsplit.length() == 0) //empty line, stay on 'idle'
-                state = CDC_cState::idle;
-            if(lsplit.length() >= 1 && lsplit[0][0] == CDC_CONF_COMMENT) { //comment, stay on 'idle'
-                state = CDC_cState::idle;
-                //qDebug() << QString(__FUNCTION__) << "found comment on line " << currLine;
-            }
-            if(lsplit.length() == 1 && lsplit[0][lsplit[0].length()-1] == CDC_CONF_COMMAND)
-                state = CDC_cState::at_header;
-
-            skip = true;
-        }
-
-        if(state == CDC_cState::at_header && !skip) {
-            state = CDC_cState::fail; // defaults to 'fail' if no transition below happens
-
-            if(lsplit.length() == 0) //empty line, stay on 'idle'
-                state = CDC_cState::idle;
-            if(lsplit.length() >= 1 && lsplit[0][0] == CDC_CONF_COMMENT) //comment, stay on 'idle'
-                state = CDC_cState::idle;
-            if(lsplit.length() == 1 && lsplit[0][lsplit[0].length()-1] == CDC_CONF_COMMAND)
-                state = CDC_cState::at_header;
-            if(lsplit.length() >= 1 && lsplit[0][lsplit[0].length()-1] != CDC_CONF_COMMAND)
-                state = CDC_cState::at_argument;
+    if(!parseContents(buffer.constData(), length, retStatus)) {
+        qDebug() << QString(__FUNCTION__) << "got a syntax error on line " << errorLine
+                 << ", column " << errorColumn << " of file" << fpath;
+        return false;
+    }
+    qDebug() << QString(__FUNCTION__) << "sucessfully parsed " << fpath;
+    return true;
+}
 
-            skip = true;
-        }
+bool configurationFileParser::parseContents(const char * data, qint64 length, CDC_status * retStatus) {
+    CDC_cLineTokens tokens;
+    CDC_cState state = CDC_cState::idle;
+    int currLine = 0;
+    qint64 pos = 0;
 
-        if(state == CDC_cState::at_argument && !skip) {
-            state = CDC_cState::fail; // defaults to 'fail' if no transition below happens
+    confFileSections.clear();
+    sectionHeaders.clear();
+    sectionIndex.clear();
+    errorLine   = 0;
+    errorColumn = 0;
 
-            if(lsplit.length() == 0) //empty line, stay on 'idle'
-                state = CDC_cState::idle;
-            if(lsplit.length() >= 1 && lsplit[0][0] == CDC_CONF_COMMENT) //comment, stay on 'idle'
-                state = CDC_cState::idle;
-            if(lsplit.length() == 1 && lsplit[0][lsplit[0].length()-1] == CDC_CONF_COMMAND)
-                state = CDC_cState::at_header;
-            if(lsplit.length() >= 1 && lsplit[0][lsplit[0].length()-1] != CDC_CONF_COMMAND)
-                state = CDC_cState::at_argument;
+    if(length >= 3 && data[0] == '\xEF' && data[1] == '\xBB' && data[2] == '\xBF') // UTF-8 BOM
+        pos = 3;
 
-            skip = true;
-        }
+    /// Finite state machine
+    while(pos < length) {
+        currLine++;
+        qint64 lineStart = pos;
+        qint64 lineEnd   = pos;
+        while(lineEnd < length && data[lineEnd] != '\n') lineEnd++;
+        pos = lineEnd + 1;
+        if(lineEnd > lineStart && data[lineEnd-1] == '\r')
+            lineEnd--;
+
+        tokenizeLine(data, lineStart, lineEnd, tokens);
+        bool isComment  = tokens.count >= 1 && data[tokens.start] == CDC_CONF_COMMENT;
+        bool endsInCmd  = tokens.count >= 1 && data[tokens.end-1] == CDC_CONF_COMMAND;
+        bool isHeader   = tokens.count == 1 && endsInCmd;
+
+        // Check state transition, according to current state. Later checks take precedence.
+        CDC_cState previous = state;
+        state = CDC_cState::fail; // defaults to 'fail' if no transition below happens
+        if(tokens.count == 0) //empty line, stay on 'idle'
+            state = CDC_cState::idle;
+        if(isComment)         //comment, stay on 'idle'
+            state = CDC_cState::idle;
+        if(isHeader)
+            state = CDC_cState::at_header;
+        if(previous != CDC_cState::idle && tokens.count >= 1 && !endsInCmd)
+            state = CDC_cState::at_argument;
 
         // Run actions of each state:
-        skip = false;
-        if(state == CDC_cState::idle) {}     // no action at 'idle'
-        if(state == CDC_cState::at_header) { // create entry, append header
+        if(state == CDC_cState::at_header) { // create entry, append header (only the retained strings are decoded)
             CDC_confSection sec;
-            sec.header.append(lsplit[0].remove(CDC_CONF_COMMAND));
+            sec.header = QString::fromUtf8(data + tokens.start, static_cast<int>(tokens.end - tokens.start))
+                         .remove(CDC_CONF_COMMAND);
             confFileSections.append(sec);
+            sectionHeaders.append(sec.header);
+            sectionIndex.insert(sec.header, confFileSections.length() - 1); // last occurrence wins
         }
         if(state == CDC_cState::at_argument) { // append content to last entry's list
-            confFileSections.last().contentsList.append(line);
+            confFileSections.last().contentsList.append(
+                        QString::fromUtf8(data + lineStart, static_cast<int>(lineEnd - lineStart)));
         }
         if(state == CDC_cState::fail) {
-            qDebug() << QString(__FUNCTION__) << "got a syntax error on line " << currLine << " of file" << fpath;
-            retval = false;
+            errorLine   = currLine;
+            // Either something outside of a section, or a header that isn't alone on its line
+            errorColumn = static_cast<int>((previous != CDC_cState::idle && tokens.count == 2 ?
+                                            tokens.nextStart : tokens.start) - lineStart) + 1;
             if(retStatus != NULL)
                 *retStatus = CDC_status::syntaxError;
-
-            return retval;
+            return false;
         }
-
     }
-
-    // End -------------------------
-    file->close();
-    if(retval)
-        qDebug() << QString(__FUNCTION__) << "sucessfully parsed " << fpath;
-    return retval;
-}
-
-QStringList configurationFileParser::getFileSections() {
-    QStringList retList;
-    for(int i=0; i < confFileSections.length(); i++)
-        retList.append(confFileSections[i].header);
-    return retList;
+    return true;
 }
 
-QStringList configurationFileParser::getSectionContents(QString secName) {
-    QStringList sections = getFileSections();
-    int idx = sections.lastIndexOf(secName);
-    if(idx != -1)
-        return confFileSections[idx].contentsList;
-    else { // Return empty list
-        QStringList retList;
-        return retList;
-    }
+const QStringList & configurationFileParser::getSectionContents(const QString &secName) const {
+    static const QStringList emptyList;
+    QHash<QString, int>::const_iterator it = sectionIndex.constFind(secName);
+    if(it == sectionIndex.constEnd())
+        return emptyList;
+    return confFileSections[it.value()].contentsList;
 }
 
 bool configurationFileParser::saveToConfigurationFile(QString filename, CDC_confList sections) {
@@ -30,6 +30,7 @@
 #include <QRegExp>
 #include <QString>
 #include <QStringList>
+#include <QHash>
 #include <QFile>
 #include <QTextStream>
 
@@ -59,24 +60,45 @@ public:
      *  - \b at-argument: After finding at least one header (command), found a line with a single string.
      *  - \b fail: Something went wrong. Function returns.
      *
+     *  The file is read into a single byte buffer (kept between calls) and tokenized in place with
+     *  parseContents() , so only the strings of the retained sections are allocated.
+     *
      *  \param fpath The full path of the file to be parsed.
-     *  \return Whether the file was correctly parsed or not.
+     *  \return Whether the file was correctly parsed or not. On syntax errors, see getErrorLine() .
      **/
     bool parseFile(QString fpath, CDC_status * retStatus = NULL);
 
     /// \brief Overloads previous definition of parseFile to deal with \em QDir type of inputs.
     bool parseFile(QDir fpath, CDC_status * retStatus = NULL) { return parseFile(fpath.absolutePath(),  retStatus); }
 
+    /** \brief Parses the UTF-8 contents of a configuration file, already in memory.
+     *
+     *  Runs the same FSM as parseFile() . Lines are split at '\\n' (a trailing '\\r' is dropped) and
+     *  tokens are kept as spans of \em data , so nothing is decoded but headers and section contents.
+     *
+     *  \param data Pointer to the contents. Not retained after the call.
+     *  \param length Number of bytes in \em data.
+     *  \return Whether the contents were correctly parsed or not.
+     **/
+    bool parseContents(const char * data, qint64 length, CDC_status * retStatus = NULL);
+
+    /// \brief Line (1-based) of the syntax error found by the last parse, 0 if none.
+    int getErrorLine()   { return errorLine;   }
+    /// \brief Column (1-based, in bytes) of the syntax error found by the last parse, 0 if none.
+    int getErrorColumn() { return errorColumn; }
+
     /** \brief Returns the list with all the commands (strings ending with ':') found.
      *
      **/
-    QStringList getFileSections();
+    const QStringList & getFileSections() const { return sectionHeaders; }
 
     /** \brief Returns the with the contents of a specific section.
      *
-     *  Returns an empty list if the section does not exist or has no contents.
+     *  Looked up in constant time. If a section appears more than once, the last occurrence wins.
+     *  Returns an empty list if the section does not exist or has no contents. The reference is
+     *  valid until the next parse.
      **/
-    QStringList getSectionContents(QString secName);
+    const QStringList & getSectionContents(const QString &secName) const;
 
     /** \brief Saves \em sections to \em filename according to CDC's syntax.
      *
@@ -85,12 +107,17 @@ public:
 
 private:
     // Attributes
-    /// \brief Current file being handled.
-    QFile * file;
-    /// \brief Text stream of the current file handle.
-    QTextStream * fileIn;
+    /// \brief Contents of the last file read by parseFile().
+    QByteArray buffer;
+    /// \brief Position of the last syntax error (0 if none).
+    int errorLine;
+    int errorColumn;
     /// \brief List of type CDC_confSection containing the sections of the read document.
     QList<CDC_confSection> confFileSections;
+    /// \brief Headers of confFileSections, in file order.
+    QStringList sectionHeaders;
+    /// \brief Index of the last section in confFileSections with a given header.
+    QHash<QString, int> sectionIndex;
 
 };
 
@@ -0,0 +1,27 @@
+QT          += core gui concurrent
+CONFIG      += thread console
+CONFIG      -= app_bundle
+TARGET      =  crossdocs_cli
+QMAKE_CXXFLAGS += -std=c++11
+
+SOURCES     += \
+            main_cli.cpp \
+            projectworker.cpp \
+            buildworker.cpp \
+            configurationfileparser.cpp \
+            documentworker.cpp \
+            piecetable.cpp \
+            inputfileparser.cpp \
+            structuremodel.cpp \
+            projectsnapshot.cpp
+
+HEADERS     += \
+            projectworker.h \
+            buildworker.h \
+            cdcdefs.h \
+            configurationfileparser.h \
+            documentworker.h \
+            piecetable.h \
+            inputfileparser.h \
+            structuremodel.h \
+            projectsnapshot.h
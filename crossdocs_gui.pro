@@ -1,4 +1,4 @@
-QT          += core gui webkitwidgets network widgets
+QT          += core gui webkitwidgets network widgets concurrent
 CONFIG      += thread
 TARGET      =  crossdocs_gui
 QMAKE_CXXFLAGS += -std=c++11
@@ -6,21 +6,35 @@ QMAKE_CXXFLAGS += -std=c++11
 SOURCES     += \
             main.cpp \
             projectworker.cpp \
+            buildworker.cpp \
             cdcmainwindow.cpp \
             configurationfileparser.cpp \
             documentworker.cpp \
+            piecetable.cpp \
             inputfileparser.cpp \
+            structuremodel.cpp \
+            logmodel.cpp \
+            projectsnapshot.cpp \
             cdchighlighter.cpp \
-            cdccodeeditor.cpp
+            cdccodeeditor.cpp \
+            cdclinenumberpainter.cpp \
+            cdclargefileview.cpp
 
 HEADERS     += \
             projectworker.h \
+            buildworker.h \
             cdcmainwindow.h \
             cdcdefs.h \
             configurationfileparser.h \
             documentworker.h \
+            piecetable.h \
             inputfileparser.h \
+            structuremodel.h \
+            logmodel.h \
+            projectsnapshot.h \
             cdchighlighter.h \
-            cdccodeeditor.h
+            cdccodeeditor.h \
+            cdclinenumberpainter.h \
+            cdclargefileview.h
 
 RESOURCES   += rsr/resources.qrc
@@ -17,6 +17,12 @@
 **/
 
 #include "documentworker.h"
+#include "projectsnapshot.h"
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 // Sections for which the parser will look for
 const QString docsecTag            = "document";
@@ -28,16 +34,17 @@ const CDC_fileSyntax defaultSyntax = CDC_fileSyntax::doxygen;
 /**************************************** CONSTRUCTOR *******************************************/
 documentWorker::documentWorker(QObject *parent) :
     QObject(parent),
-    buildEngine(CDC_buildEngine::none)
+    buildEngine(CDC_buildEngine::none),
+    configured(false),
+    structureOutdated(true),
+    missingInputFiles(false),
+    parallelStructureExtraction(true)
 {
-    fp        = new configurationFileParser();
-    infp      = new inputFileParser();
-    structure = new QStandardItemModel();
+    fp = new configurationFileParser();
 }
 
 documentWorker::~documentWorker() {
     delete fp;
-    delete infp;
     cddFile->close();
     for (int i = 0; i < inputFiles.length(); ++i)
         inputFiles[i].file->close();
@@ -47,12 +54,15 @@ documentWorker::~documentWorker() {
 
 /**************************************** METHODS ***********************************************/
 bool documentWorker::configureDocument(QString docConfPath, CDC_status *retStatus) {
+    configured = false;
     if(!docConfPath.isEmpty())
         cddFilePath = docConfPath;
 
     cddFile = new QFile(cddFilePath);
     // Clean everything that might be from other parse
     inputFiles.clear();
+    structureOutdated = true;
+    missingInputFiles = false;
 
     QDir dir(cddFilePath);
     basePath = QString(cddFilePath);
@@ -71,8 +81,10 @@ bool documentWorker::configureDocument(QString docConfPath, CDC_status *retStatu
             qWarning() << QString(__FUNCTION__) << "Failed to create " << tag;
             return false;
         }
-        else
+        else {
+            configured = true;
             return true; //Document was created, no point in parsing it again
+        }
     }
     // Cdd file exists already, parse it
     if(!fp->parseFile(cddFilePath)) {
@@ -105,20 +117,17 @@ bool documentWorker::configureDocument(QString docConfPath, CDC_status *retStatu
             else
                 ifile = new QFile(basePath + tempTag[i]);
 
-            if(!ifile->exists())
+            if(!ifile->exists()) {
                 qWarning() << QString(__FUNCTION__) << "In " << tag
                            << ": input file doesnt exist: "<< tempTag[i] << " Will be ignored!";
+                missingInputFiles = true;
+                delete ifile;
+            }
             else {
                 qDebug() << QString(__FUNCTION__) << "Found input file"<< tempTag[i];
                 // All ok! Appending new input file to document's list
-                CDC_inputFile newInputFile;
                 ifile->setFileName(QFileInfo::QFileInfo(*ifile).canonicalFilePath());
-                newInputFile.file = ifile;
-                newInputFile.modified = false;
-                newInputFile.contents = QString("");
-                newInputFile.buildEngine = buildEngine;
-                newInputFile.syntax = defaultSyntax;
-                inputFiles.append(newInputFile);
+                appendInputFile(ifile);
             }
         }
     }
@@ -132,9 +141,38 @@ bool documentWorker::configureDocument(QString docConfPath, CDC_status *retStatu
     else
         name = tempTag[0];
 
+    configured = true;
     return true;
 }
 
+bool documentWorker::restoreConfiguration(QString docConfPath, QString doctag, QString docname,
+                                          const QStringList &inputFilePaths) {
+    cddFilePath = docConfPath;
+    cddFile     = new QFile(cddFilePath);
+    tag         = doctag;
+    name        = docname;
+    inputFiles.clear();
+    structureOutdated = true;
+    missingInputFiles = false;
+
+    QDir dir(cddFilePath);
+    basePath = QString(cddFilePath);
+    basePath.chop(dir.dirName().length());
+
+    // Paths are canonical already
+    for (int i = 0; i < inputFilePaths.length(); ++i) {
+        if(!QFile::exists(inputFilePaths[i])) {
+            qWarning() << QString(__FUNCTION__) << "In " << tag
+                       << ": input file doesnt exist: "<< inputFilePaths[i] << " Will be ignored!";
+            missingInputFiles = true;
+            continue;
+        }
+        appendInputFile(new QFile(inputFilePaths[i]));
+    }
+    configured = true;
+    return !missingInputFiles;
+}
+
 QString documentWorker::getInputFileContents(int index, CDC_status * retStatus) {
     if(retStatus != NULL) *retStatus = CDC_status::ok;
 
@@ -143,17 +181,37 @@ QString documentWorker::getInputFileContents(int index, CDC_status * retStatus)
         if(retStatus != NULL) *retStatus = CDC_status::paramError;
         return QString::QString("");
     }
-    if(inputFiles[index].contents.isEmpty()) {
-        if(!inputFiles[index].file->isOpen())
-            if(!inputFiles[index].file->open(QIODevice::ReadWrite)) {
-                qWarning() << QString(__FUNCTION__) << "Unable to load file " << inputFiles[index].file->fileName();
-                if(retStatus != NULL) *retStatus = CDC_status::ioError;
-                return QString::QString("");
-            }
-        inputFiles[index].contents = QTextStream::QTextStream(inputFiles[index].file).readAll();
-        inputFiles[index].file->close();
+    if(inputFiles[index].buffer->contents.isEmpty() && !inputFiles[index].buffer->modified) {
+        QString contents;
+        // Stamped before reading: if the file changes meanwhile, the stamp is the outdated one
+        CDC_fileStamp stamp = projectSnapshot::stampOf(inputFiles[index].file->fileName());
+        if(!readFileContents(inputFiles[index].file, contents)) {
+            qWarning() << QString(__FUNCTION__) << "Unable to load file " << inputFiles[index].file->fileName();
+            if(retStatus != NULL) *retStatus = CDC_status::ioError;
+            return QString::QString("");
+        }
+        inputFiles[index].buffer->contents = pieceTable(contents);
+        inputFiles[index].buffer->stamp    = stamp;
     }
-    return inputFiles[index].contents;
+    return inputFiles[index].buffer->contents.toString();
+}
+
+bool documentWorker::readFileContents(QFile * file, QString &contents) {
+    if(!file->isOpen() && !file->open(QIODevice::ReadOnly))
+        return false;
+    contents = QString("");
+    // Decode straight from the mapped file, with no intermediate copy
+    if(file->size() > 0) {
+        uchar * data = file->map(0, file->size());
+        if(data != NULL) {
+            contents = QString::fromUtf8(reinterpret_cast<const char *>(data), file->size());
+            file->unmap(data);
+        }
+        else
+            contents = QString::fromUtf8(file->readAll());
+    }
+    file->close();
+    return true;
 }
 
 void documentWorker::setInputFileContents(int index, QString content, CDC_status * retStatus) {
@@ -163,30 +221,96 @@ void documentWorker::setInputFileContents(int index, QString content, CDC_status
         if(retStatus != NULL) *retStatus = CDC_status::paramError;
         return;
     }
-    if(inputFiles[index].contents.compare(content) != 0) {
-        inputFiles[index].contents = content;
-        inputFiles[index].modified = true;
+    inputFiles[index].buffer->contents = pieceTable(content);
+    inputFiles[index].buffer->modified = true;
+    inputFiles[index].buffer->revision++;
+}
+
+void documentWorker::editInputFileContents(int index, int position, int removed, const QString &added, CDC_status * retStatus) {
+    if(retStatus != NULL) *retStatus = CDC_status::ok;
+    if(!(index < inputFiles.length() && index >= 0)) {
+        qWarning() << QString(__FUNCTION__) << "Invalid index";
+        if(retStatus != NULL) *retStatus = CDC_status::paramError;
+        return;
+    }
+    pieceTable &contents = inputFiles[index].buffer->contents;
+    if(position < 0 || removed < 0 || position + removed > contents.length()) {
+        qWarning() << QString(__FUNCTION__) << "Edit out of range";
+        if(retStatus != NULL) *retStatus = CDC_status::paramError;
+        return;
     }
+    if(removed == added.length() && contents.mid(position, removed) == added)
+        return;
+    contents.replace(position, removed, added);
+    inputFiles[index].buffer->modified = true;
+    inputFiles[index].buffer->revision++;
 }
 
 bool documentWorker::saveInputFile(int index, CDC_status * retStatus) {
     if(retStatus != NULL) *retStatus = CDC_status::ok;
     if(!(index < inputFiles.length() && index >= 0)) {
         qWarning() << QString(__FUNCTION__) << "Invalid index";
-        *retStatus = CDC_status::paramError;
+        if(retStatus != NULL) *retStatus = CDC_status::paramError;
         return false;
     }
-    if(inputFiles[index].modified) { // don't bother saving file if content wasn't changed
-        if(!inputFiles[index].file->open(QIODevice::WriteOnly)) {
-            qWarning() << QString(__FUNCTION__) << "Unble to save to file " << inputFiles[index].file->fileName();
+    if(inputFiles[index].buffer->modified) { // don't bother saving file if content wasn't changed
+        QString path = inputFiles[index].file->fileName();
+        if(!writeFileContents(path, inputFiles[index].buffer->contents)) {
+            qWarning() << QString(__FUNCTION__) << "Unble to save to file " << path;
             if(retStatus != NULL) *retStatus = CDC_status::ioError;
             return false;
         }
-        QTextStream in(inputFiles[index].file);
-        in << inputFiles[index].contents;
-        inputFiles[index].file->close();
+        syncDirectory(QFileInfo(path).absolutePath());
+        inputFiles[index].buffer->modified = false;
+        inputFiles[index].buffer->stamp    = projectSnapshot::stampOf(path);
+    }
+    return true;
+}
+
+bool documentWorker::writeFileContents(const QString &path, const pieceTable &contents) {
+    // Written to a temporary file next to the target, synced and then renamed over it
+    QSaveFile file(path);
+    if(!file.open(QIODevice::WriteOnly))
+        return false;
+    if(!contents.write(&file)) {
+        file.cancelWriting();
+        return false;
     }
+    return file.commit();
+}
+
+bool documentWorker::syncDirectory(const QString &dirPath) {
+#ifdef Q_OS_UNIX
+    // Makes the renames done by writeFileContents() durable
+    int fd = ::open(QFile::encodeName(dirPath).constData(), O_RDONLY);
+    if(fd < 0)
+        return false;
+    bool retval = ::fsync(fd) == 0;
+    ::close(fd);
+    return retval;
+#else
+    Q_UNUSED(dirPath);
     return true;
+#endif
+}
+
+CDC_inputFileHandle documentWorker::getInputFileBuffer(int index) {
+    if(!(index < inputFiles.length() && index >= 0)) {
+        qWarning() << QString(__FUNCTION__) << "Invalid index";
+        return CDC_inputFileHandle();
+    }
+    return inputFiles[index].buffer;
+}
+
+void documentWorker::setInputFileBuffer(int index, CDC_inputFileHandle buffer) {
+    if(!(index < inputFiles.length() && index >= 0) || buffer.isNull()) {
+        qWarning() << QString(__FUNCTION__) << "Invalid index or buffer";
+        return;
+    }
+    if(inputFiles[index].buffer != buffer) {
+        inputFiles[index].buffer = buffer;
+        inputFiles[index].structureRevision = -1; // Revisions of different buffers can't be compared
+    }
 }
 
 void documentWorker::setInputFileSyntax(int index, CDC_fileSyntax syntax) {
@@ -194,7 +318,10 @@ void documentWorker::setInputFileSyntax(int index, CDC_fileSyntax syntax) {
         qWarning() << QString(__FUNCTION__) << "Invalid index";
         return;
     }
-    inputFiles[index].syntax = syntax;
+    if(inputFiles[index].syntax != syntax) {
+        inputFiles[index].syntax = syntax;
+        inputFiles[index].structureRevision = -1; // Has to be parsed again with the new rules
+    }
 }
 
 CDC_fileSyntax documentWorker::getInputFileSyntax(int index) {
@@ -217,59 +344,183 @@ bool documentWorker::isModified(int index) {
         qWarning() << QString(__FUNCTION__) << "Invalid index";
         return false;
     }
-    return inputFiles[index].modified;
+    return inputFiles[index].buffer->modified;
+}
+
+QList<QList<CDC_docStructuralElement> > documentWorker::getDocumentStructure() {
+    QList<QList<CDC_docStructuralElement> > files;
+
+    updateStructureCache();
+
+    for (int i = 0; i < inputFiles.length(); ++i)
+        files.append(inputFiles[i].structureList);
+    structureOutdated = false;
+    return files;
+}
+
+void documentWorker::updateStructureCache() {
+    QList<CDC_structureJob> jobs;
+    getStructureJobs(jobs);
+    // Each job works on its own data, so files can be parsed on the thread pool. The results are
+    // only stored afterwards, back on the calling thread.
+    if(parallelStructureExtraction && jobs.length() > 1)
+        QtConcurrent::blockingMap(jobs, runStructureJob);
+    else
+        for (int i = 0; i < jobs.length(); ++i)
+            runStructureJob(jobs[i]);
+    applyStructureJobs(jobs);
 }
 
-QStandardItemModel * documentWorker::getDocumentStructure() {
-    structure->clear();
-
-    // Append root item that refers to the document's self
-    QStandardItem * rootItem = new QStandardItem(name);
-    rootItem->setToolTip("Document tag: " + tag);
-    rootItem->setData(QVariant(tag), CDC_docStructuralElementRole::Tag );
-    rootItem->setData(QVariant(tag), CDC_docStructuralElementRole::Doc ); // Is his own parent
-    rootItem->setData(QVariant(-1),  CDC_docStructuralElementRole::Line);
-    rootItem->setData(QVariant(static_cast<int>(CDC_docStructuralElementType::document)),
-                     CDC_docStructuralElementRole::Type);
-    QFont ifont = rootItem->font(); ifont.setBold(true);
-    rootItem->setFont(ifont);
-    rootItem->setEditable(false);
-
-    infp->setParentDocumentTag(tag);
+void documentWorker::getStructureJobs(QList<CDC_structureJob> &jobs) {
+    // Only parse input files whose contents changed since their structure was cached
     for (int i = 0; i < inputFiles.length(); ++i) {
-        infp->setSyntax(inputFiles[i].syntax);
-        infp->setIndexOfCurrentFile(i);
-        if(infp->parseInputFile(getInputFileContents(i))) {
-            // This transfers ownership of the underlying model elemnts, so that they
-            // don't get deleted by its original parent
-            if(infp->getStructure()->columnCount() > 0) {
-                if(!(rootItem->columnCount() > 0))
-                    rootItem->appendColumn(infp->getStructure()->takeColumn(0));
-                else
-                    rootItem->appendColumn(rootItem->takeColumn(0) << infp->getStructure()->takeColumn(0));
-            }
+        if(inputFiles[i].structureRevision != inputFiles[i].buffer->revision) {
+            CDC_structureJob job;
+            job.index    = i;
+            job.revision = inputFiles[i].buffer->revision;
+            job.syntax   = inputFiles[i].syntax;
+            job.stamp.size     = -1; // set by runStructureJob() when scanning from disk
+            job.stamp.modified = 0;
+            // Files that were never loaded into the editor are memory-mapped by the job itself
+            if(inputFiles[i].buffer->contents.isEmpty() && !inputFiles[i].buffer->modified)
+                job.filePath = inputFiles[i].file->fileName();
+            else
+                job.contents = inputFiles[i].buffer->contents;
+            jobs.append(job);
         }
     }
+}
 
-    structure->appendRow(rootItem);
-    return structure;
+bool documentWorker::applyStructureJobs(const QList<CDC_structureJob> &jobs) {
+    bool upToDate = true;
+    bool changed  = false;
+    for (int i = 0; i < jobs.length(); ++i) {
+        int index = jobs[i].index;
+        if(index >= inputFiles.length() || jobs[i].revision != inputFiles[index].buffer->revision) {
+            upToDate = false; // contents changed while the job ran: its result is already stale
+            continue;
+        }
+        inputFiles[index].structureList     = jobs[i].elements;
+        inputFiles[index].structureRevision = jobs[i].revision;
+        inputFiles[index].structureStamp    = jobs[i].stamp;
+        changed = true;
+    }
+    if(changed)
+        updateStructureIndex();
+    return upToDate;
 }
 
-int documentWorker::getLineOfStructuralElement(QString elemtag) {
-    int retval = -1;
-    for(int i = 0; i < structureList.length(); ++i) {
-        if(structureList[i].tag.compare(elemtag) == 0)
-            retval = structureList[i].line;
+void documentWorker::runStructureJob(CDC_structureJob &job) {
+    if(!job.filePath.isEmpty()) {
+        job.stamp = projectSnapshot::stampOf(job.filePath); // before reading, as for loaded contents
+        QFile file(job.filePath);
+        inputFileParser::extractStructure(job.syntax, &file, job.elements);
     }
-    return retval;
+    else
+        inputFileParser::extractStructure(job.syntax, job.contents.toString(), job.elements);
 }
 
-int documentWorker::getIndexOfStructuralElement(QString elemtag) {
-    int retval = -1;
-    for(int i = 0; i < structureList.length(); ++i) {
-        if(structureList[i].tag.compare(elemtag) == 0)
-            retval = structureList[i].index;
+bool documentWorker::getCachedStructure(int index, QList<CDC_docStructuralElement> &elements, CDC_fileStamp &stamp) {
+    if(!(index < inputFiles.length() && index >= 0)
+            || inputFiles[index].buffer->modified
+            || inputFiles[index].structureRevision != inputFiles[index].buffer->revision)
+        return false;
+    // The structure matches the buffer: loaded buffers know which file they match, others were scanned from disk
+    const CDC_inputFileBuffer &buffer = *inputFiles[index].buffer;
+    stamp = buffer.stamp.size >= 0 ? buffer.stamp : inputFiles[index].structureStamp;
+    if(stamp.size < 0)
+        return false;
+    elements = inputFiles[index].structureList;
+    return true;
+}
+
+void documentWorker::restoreStructureCache(const QHash<int, QList<CDC_docStructuralElement> > &structures,
+                                           const QHash<int, CDC_fileStamp> &stamps) {
+    CDC_fileStamp unknown = { -1, 0 };
+    QHash<int, QList<CDC_docStructuralElement> >::const_iterator it;
+    for (it = structures.constBegin(); it != structures.constEnd(); ++it) {
+        if(it.key() < 0 || it.key() >= inputFiles.length())
+            continue;
+        inputFiles[it.key()].structureList     = it.value();
+        inputFiles[it.key()].structureRevision = inputFiles[it.key()].buffer->revision;
+        inputFiles[it.key()].structureStamp    = stamps.value(it.key(), unknown);
     }
-    return retval;
+    if(!structures.isEmpty())
+        updateStructureIndex();
+}
+
+int documentWorker::getStructuralElementCount() {
+    int count = 0;
+    for (int i = 0; i < inputFiles.length(); ++i)
+        count += inputFiles[i].structureList.length();
+    return count;
+}
+
+bool documentWorker::isStructureOutdated() {
+    if(structureOutdated)
+        return true;
+    for (int i = 0; i < inputFiles.length(); ++i)
+        if(inputFiles[i].structureRevision != inputFiles[i].buffer->revision)
+            return true;
+    return false;
+}
+
+int documentWorker::getLineOfStructuralElement(QString elemtag) {
+    CDC_docStructuralElementLocation location;
+    return getStructuralElementLocation(elemtag, location) ? location.line : -1;
+}
+
+int documentWorker::getIndexOfStructuralElement(QString elemtag) {
+    CDC_docStructuralElementLocation location;
+    return getStructuralElementLocation(elemtag, location) ? location.index : -1;
+}
+
+bool documentWorker::getStructuralElementLocation(QString elemtag, CDC_docStructuralElementLocation &location) {
+    QHash<QString, CDC_docStructuralElementLocation>::const_iterator it = structureIndex.constFind(elemtag);
+    if(it == structureIndex.constEnd())
+        return false;
+    location = it.value();
+    return true;
+}
+
+// PRIVATE ------------------------------------------------------------------------
+void documentWorker::appendInputFile(QFile * ifile) {
+    CDC_inputFile newInputFile;
+    newInputFile.file = ifile;
+    newInputFile.buffer = CDC_inputFileHandle(new CDC_inputFileBuffer);
+    newInputFile.buffer->contents = pieceTable();
+    newInputFile.buffer->modified = false;
+    newInputFile.buffer->revision = 0;
+    newInputFile.buffer->stamp.size     = -1;
+    newInputFile.buffer->stamp.modified = 0;
+    newInputFile.buildEngine = buildEngine;
+    newInputFile.syntax = defaultSyntax;
+    newInputFile.structureRevision = -1;
+    newInputFile.structureStamp    = newInputFile.buffer->stamp;
+    inputFiles.append(newInputFile);
 }
 
+void documentWorker::updateStructureIndex() {
+    CDC_docStructuralElementLocation location;
+    structureIndex.clear();
+    repeatedStructuralTags.clear();
+    location.doc = tag;
+
+    for (int i = 0; i < inputFiles.length(); ++i) {
+        location.fileIndex = i;
+        for (int j = 0; j < inputFiles[i].structureList.length(); ++j) {
+            const CDC_docStructuralElement &se = inputFiles[i].structureList[j];
+            if(structureIndex.contains(se.tag)) {
+                qWarning() << QString(__FUNCTION__) << "In" << tag << ": repeated structural tag" << se.tag
+                           << "on line" << se.line << "of" << inputFiles[i].file->fileName();
+                if(!repeatedStructuralTags.contains(se.tag))
+                    repeatedStructuralTags.append(se.tag);
+                continue;
+            }
+            location.line  = se.line;
+            location.index = se.index;
+            location.type  = se.type;
+            structureIndex.insert(se.tag, location);
+        }
+    }
+}
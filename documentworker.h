@@ -23,8 +23,10 @@
 #include <QDebug>
 #include <QProcess>
 #include <QFile>
+#include <QSaveFile>
 #include <QDir>
-#include <QStandardItemModel>
+#include <QHash>
+#include <QtConcurrent>
 
 #include "cdcdefs.h"
 #include "configurationfileparser.h"
@@ -39,22 +41,56 @@ public:
 
     bool configureDocument(QString docConfPath = QString::QString(""), CDC_status *retStatus = NULL);
 
+    /**
+     * @brief Whether the last call to configureDocument() succeeded.
+     * Documents are configured concurrently by projectWorker, so this is how it collects the results.
+     */
+    bool isConfigured() { return configured; }
+
+    /**
+     * @brief Configures the document from data saved in a project snapshot, without parsing its cdd file.
+     * @param inputFilePaths Canonical paths of the input files, in document order.
+     * @return FALSE if any input file doesn't exist anymore (it is left out, as configureDocument() would).
+     */
+    bool restoreConfiguration(QString docConfPath, QString doctag, QString docname, const QStringList &inputFilePaths);
+
+    /// \brief Whether any input file listed in the cdd file was not found by the last configuration.
+    bool hasMissingInputFiles() { return missingInputFiles; }
+
     /**
      * @brief Reads contents of file into inputFileContents and the returns them.
      * Reads the file once from the filesystem into application, then return the struct.
+     * This is the only place where input files get decoded into a \b QString : their structure is
+     * extracted from memory-mapped UTF-8 bytes until they are actually needed (e.g. by the editor).
      * @param index Index of the file in the internal inputFiles structure.
      * @return String containing the whole plain-text file.
      */
     QString getInputFileContents(int index, CDC_status * retStatus = NULL);
 
+    /**
+     * @brief Reads and decodes (UTF-8) the whole contents of \em file , through a memory map if possible.
+     * @return FALSE if the file could not be opened.
+     */
+    static bool readFileContents(QFile * file, QString &contents);
+
     /**
      * @brief Sets the n-th inputFileContents element to the given \em content argument.
-     * The contents of the n-th input file are altered and the n-th \em modified flag is set.
+     * The contents of the n-th input file are replaced, the n-th \em modified flag is set and the buffer's
+     * revision is incremented (contents are not compared: use editInputFileContents() for small changes).
      * @param index Index of the document to be changed (i.e., element in inputFileContents)
      * @param content QString containing the contents of the file.
      */
     void setInputFileContents(int index, QString content, CDC_status * retStatus = NULL);
 
+    /**
+     * @brief Replaces \em removed characters at \em position of the n-th input file with \em added .
+     * Meant to follow an editor change by change (see \b QTextDocument::contentsChange ), without copying
+     * the whole text around. A change that leaves the text as it was (e.g. emitted by a syntax highlighter)
+     * is ignored; any other sets the \em modified flag and increments the buffer's revision.
+     * @param retStatus CDC_status::paramError if the range is outside the contents (nothing is changed).
+     */
+    void editInputFileContents(int index, int position, int removed, const QString &added, CDC_status * retStatus = NULL);
+
     /**
      * @brief Saves the content of the n-th inputFileContents to the file.
      * @param index Index of the file to be saved.
@@ -63,6 +99,30 @@ public:
      */
     bool saveInputFile(int index, CDC_status * retStatus = NULL);
 
+    /**
+     * @brief Atomically replaces the contents of \em path with \em contents (UTF-8).
+     * The data goes to a temporary file (\b QSaveFile ), streamed piece by piece (see pieceTable::write() ),
+     * which is synced and only then renamed over the target: if anything fails midway, the original file
+     * is left untouched. Touches no documentWorker state, so it can be called from worker threads.
+     * @return Whether the file was written and renamed.
+     */
+    static bool writeFileContents(const QString &path, const pieceTable &contents);
+
+    /// \brief Syncs the directory entries of \em dirPath , so renames into it survive a crash (no-op off Unix).
+    static bool syncDirectory(const QString &dirPath);
+
+    /**
+     * @brief Returns the handle to the buffer holding the contents of the n-th input file.
+     * @return Null handle if \em index is invalid.
+     */
+    CDC_inputFileHandle getInputFileBuffer(int index);
+
+    /**
+     * @brief Makes the n-th input file use \em buffer for its contents.
+     * Used by projectWorker so that all documents that include the same file share a single buffer.
+     */
+    void setInputFileBuffer(int index, CDC_inputFileHandle buffer);
+
     void setInputFileSyntax(int index, CDC_fileSyntax syntax);
     CDC_fileSyntax getInputFileSyntax(int index);
 
@@ -80,20 +140,88 @@ public:
     bool isModified(int index);
 
     /**
-     * @brief Creates and returns the document's structure (sections, subsections, etc.)
-     * Uses the inputFileParser::parseInputFile() method to generate the structure for each
-     * input file. Applies this sequentially to each input file and then stitches those structures
-     * together, which generates the structure of the "bigger picture".
+     * @brief Returns the document's structure (sections, subsections, etc.), per input file.
+     * Uses inputFileParser::extractStructure() to get the structural elements of each input file, in
+     * the order the files appear in the document. Stitching them together into the "bigger picture"
+     * is up to the caller (see structureModel::setDocumentStructure() ).
      * Simultaneously updates the internal structural element list, that is later used for
      * line number and index information checking.
+     * The structural elements of each input file are cached along with the revision of the contents
+     * they were taken from, so only input files that changed since the last call are parsed again.
+     * If parallel structure extraction is enabled, those files are parsed concurrently.
      * @attention This whole thing is based on the idea that ALL stuctural tags in a document are different.
      * Violating this will generate unexpected behaviors!
-     * @return The \b QStandardItemModel object containing the representation of the document's structure.
+     * @return One list of structural elements for each input file.
+     */
+    QList<QList<CDC_docStructuralElement> > getDocumentStructure();
+
+    /**
+     * @brief Parses the input files that changed since their structure was last cached.
+     * This is the part of getDocumentStructure() that doesn't copy the element lists out, so it can be used
+     * by front-ends that have no tree to show (e.g. the command line one).
+     */
+    void updateStructureCache();
+
+    /**
+     * @brief Appends one job to \em jobs for each input file whose structure is outdated.
+     * Jobs hold a snapshot of the contents (or the path of the file, if it was never loaded), so they
+     * can be run with runStructureJob() on any thread while the document keeps being edited.
+     */
+    void getStructureJobs(QList<CDC_structureJob> &jobs);
+
+    /**
+     * @brief Stores the results of jobs taken with getStructureJobs() , once they have been run.
+     * Results of files whose contents changed in the meantime are stale, and are thrown away.
+     * @return Whether all results could be stored (FALSE if any was stale).
+     */
+    bool applyStructureJobs(const QList<CDC_structureJob> &jobs);
+
+    /// \brief Runs inputFileParser::extractStructure() on \em job . Touches no documentWorker state.
+    static void runStructureJob(CDC_structureJob &job);
+
+    /**
+     * @brief Gets the cached structure of the n-th input file, if it matches the file on disk.
+     * @param stamp Receives the stamp the file had when the contents the structure comes from were read,
+     * which is not necessarily the file's current one.
+     * @return FALSE if the structure is outdated, if the file has unsaved modifications, or if it is not
+     * known which version of the file the structure comes from.
      */
-    QStandardItemModel * getDocumentStructure();
+    bool getCachedStructure(int index, QList<CDC_docStructuralElement> &elements, CDC_fileStamp &stamp);
+
+    /**
+     * @brief Seeds the structure cache of some input files (e.g. from a project snapshot).
+     * The elements are taken as the structure of the current contents, so those files are not parsed.
+     * @param structures Structural elements, by input file index.
+     * @param stamps Stamps of the files the elements were extracted from, by input file index.
+     */
+    void restoreStructureCache(const QHash<int, QList<CDC_docStructuralElement> > &structures,
+                               const QHash<int, CDC_fileStamp> &stamps);
+
+    /// \brief Number of structural elements currently cached for all input files.
+    int getStructuralElementCount();
+
+    /**
+     * @brief Checks whether getDocumentStructure() would yield a different structure than the last one.
+     * @return TRUE if the structure was never built, or if any input file changed since it was built.
+     */
+    bool isStructureOutdated();
     int getLineOfStructuralElement(QString elemtag);
     int getIndexOfStructuralElement(QString elemtag);
 
+    /**
+     * @brief Looks \em elemtag up in the document's structural tag index.
+     * @param elemtag Tag of the desired structural element.
+     * @param location Receives where the element is, if found.
+     * @return Whether the tag exists in the document.
+     */
+    bool getStructuralElementLocation(QString elemtag, CDC_docStructuralElementLocation &location);
+
+    /// \brief Index of all structural tags of the document. Up to date after updateStructureCache() .
+    const QHash<QString, CDC_docStructuralElementLocation> & getStructureIndex() { return structureIndex; }
+
+    /// \brief Tags found more than once in the document, during the last index update.
+    QStringList getRepeatedStructuralTags() { return repeatedStructuralTags; }
+
 
     // Getters and setters
     QString getTag() { return tag; }
@@ -104,30 +232,50 @@ public:
     void setConfFilePath(QString value) { cddFilePath = value; }
     CDC_buildEngine getBuildEngine() { return buildEngine; }
     void setBuildEngine(CDC_buildEngine value) { buildEngine = value; }
+    bool getParallelStructureExtraction() { return parallelStructureExtraction; }
+    void setParallelStructureExtraction(bool value) { parallelStructureExtraction = value; }
 
 private:
     QString tag;
     QString name;
     QString cddFilePath;
     CDC_buildEngine buildEngine;
+    bool configured;
 
     QString basePath;   /// Relative to the cdd file.
     QFile * cddFile;    /// Configuration file for document.
 
     typedef struct {
         QFile * file;                /// Stores QFile of n-th input file
-        QString contents;            /// Stores loaded plain-text contents of n-th file
-        bool modified;               /// Stores TRUE if file the n-th file was modified and not saved
+        CDC_inputFileHandle buffer;  /// Contents of the n-th file (possibly shared with other documents)
         CDC_buildEngine buildEngine; /// Input file's build engine. Defaults to document's setting .
         CDC_fileSyntax syntax;       /// Syntax analysis and highlighting
+        int structureRevision;       /// Buffer revision the cached structure was parsed from (-1 if not parsed)
+        CDC_fileStamp structureStamp;/// File as scanned from disk for the cached structure (size -1 if not)
+        QList<CDC_docStructuralElement> structureList; /// Cached structural elements of the n-th file
     } CDC_inputFile;
 
     QList<CDC_inputFile> inputFiles;
-    QList<CDC_docStructuralElement> structureList;
-    QStandardItemModel * structure;
+    QHash<QString, CDC_docStructuralElementLocation> structureIndex; /// Structural tag -> location
+    QStringList repeatedStructuralTags;
+    bool structureOutdated;     /// Set when the document's own data (not its IFs) invalidates the structure
+    bool missingInputFiles;     /// Set when an input file listed in the cdd file was not found
+
+    bool parallelStructureExtraction; /// Whether outdated input files are parsed on the thread pool
 
     configurationFileParser * fp;
-    inputFileParser * infp;
+
+    // Methods
+
+    /// \brief Appends \em ifile (canonical path, must exist) to the input files, with an empty buffer.
+    void appendInputFile(QFile * ifile);
+
+    /**
+     * @brief Rebuilds structureIndex out of the cached elements of all input files.
+     * Repeated tags are reported and kept out of the index after their first occurrence, which is
+     * the one navigation will lead to.
+     */
+    void updateStructureIndex();
 
 signals:
 
@@ -18,10 +18,218 @@
 
 #include "inputfileparser.h"
 
+#include <cstring>
+
+/* Local Types --------------------------------------------------------------*/
+
+/// Entry of a syntax's keyword table. The keyword is stored without its leading backslash.
+typedef struct {
+    const char * keyword;
+    int length;
+    CDC_docStructuralElementType type;
+} CDC_structuralKeyword;
+
+// Structural commands recognized on doxygen files
+static const CDC_structuralKeyword doxygenKeywords[] = {
+    { "section",       7,  CDC_docStructuralElementType::section       },
+    { "subsection",    10, CDC_docStructuralElementType::subsection    },
+    { "subsubsection", 13, CDC_docStructuralElementType::subsubsection },
+    { "paragraph",     9,  CDC_docStructuralElementType::paragraph     }
+};
+static const int doxygenKeywordCount = sizeof(doxygenKeywords)/sizeof(doxygenKeywords[0]);
+
+/* Local Functions ----------------------------------------------------------*/
+
+// Character classes, for decoded contents (QChar) and for memory-mapped UTF-8 bytes (char).
+// Only ASCII lines are scanned as bytes (see scanUtf8Line() ), and on ASCII both agree.
+
+/// Same definition of a word character as QRegExp's \w
+static inline bool isWordChar(const QChar &c) {
+    return c.isLetterOrNumber() || c.isMark() || c == QLatin1Char('_');
+}
+static inline bool isWordChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+static inline bool isSpaceChar(const QChar &c) { return c.isSpace(); }
+static inline bool isSpaceChar(char c)         { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+static inline bool isAsciiChar(const QChar &c, char ascii) { return c == QLatin1Char(ascii); }
+static inline bool isAsciiChar(char c, char ascii)         { return c == ascii; }
+
+static inline qint64 findNewline(const QChar * data, qint64 from, qint64 length) {
+    for (qint64 i = from; i < length; ++i)
+        if(data[i] == QLatin1Char('\n'))
+            return i;
+    return -1;
+}
+static inline qint64 findNewline(const char * data, qint64 from, qint64 length) {
+    const void * p = memchr(data + from, '\n', length - from);
+    return p == NULL ? -1 : static_cast<const char *>(p) - data;
+}
+
+/// Implementation of inputFileParser::scanStructuralCommand() for both character types.
+template <typename T>
+static bool scanLine(CDC_fileSyntax syntax, const T * line, int length, CDC_structuralCommand &command) {
+    const CDC_structuralKeyword * keywords;
+    int keywordCount;
+    int pos, mark, j;
+
+    switch (syntax) {
+    case CDC_fileSyntax::doxygen:
+            keywords     = doxygenKeywords;
+            keywordCount = doxygenKeywordCount;
+        break;
+    default:
+        return false;
+        break;
+    }
+
+    for (int i = 0; i < length; ++i) {
+        if(!isAsciiChar(line[i], '\\'))
+            continue;
+
+        for (int k = 0; k < keywordCount; ++k) {
+            // Command keyword
+            pos = i + 1;
+            for (j = 0; j < keywords[k].length && pos < length; ++j, ++pos)
+                if(!isAsciiChar(line[pos], keywords[k].keyword[j]))
+                    break;
+            if(j < keywords[k].length)
+                continue;
+
+            // Whitespaces between command and tag
+            mark = pos;
+            while(pos < length && isSpaceChar(line[pos])) pos++;
+            if(pos == mark)
+                continue;
+
+            // Tag
+            mark = pos;
+            while(pos < length && isWordChar(line[pos])) pos++;
+            if(pos == mark)
+                continue;
+            command.tagStart  = mark;
+            command.tagLength = pos - mark;
+
+            // Whitespaces between tag and name
+            mark = pos;
+            while(pos < length && isSpaceChar(line[pos])) pos++;
+            if(pos == mark)
+                continue;
+
+            // Name (rest of the line)
+            command.nameStart     = pos;
+            command.nameLength    = length - pos;
+            command.index         = i;
+            command.commandLength = keywords[k].length + 1;
+            command.type          = keywords[k].type;
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline bool isAsciiLine(const char * line, int length) {
+    for (int i = 0; i < length; ++i)
+        if(line[i] & 0x80)
+            return false;
+    return true;
+}
+
+/**
+ * Scans a UTF-8 line exactly as its decoded text would be scanned: ASCII lines are scanned in place,
+ * any other line that may hold a command is decoded first. Spans are in UTF-16 code units either way,
+ * and if \em decoded is given, it receives the decoded line (left empty for ASCII lines).
+ */
+static bool scanUtf8Line(CDC_fileSyntax syntax, const char * line, int length, CDC_structuralCommand &command,
+                         QString * decoded = NULL) {
+    if(memchr(line, '\\', length) == NULL)
+        return false;
+    if(isAsciiLine(line, length))
+        return scanLine(syntax, line, length, command);
+    QString text = QString::fromUtf8(line, length);
+    if(decoded != NULL)
+        *decoded = text;
+    return scanLine(syntax, text.constData(), text.length(), command);
+}
+
+/// Scans one line, filling the tag, name and column of \em element if a structural command is found.
+static inline bool scanElement(CDC_fileSyntax syntax, const QChar * line, int length,
+                               CDC_structuralCommand &command, CDC_docStructuralElement &element) {
+    if(!scanLine(syntax, line, length, command))
+        return false;
+    element.tag   = QString(line + command.tagStart,  command.tagLength);
+    element.name  = QString(line + command.nameStart, command.nameLength);
+    element.index = command.index;
+    return true;
+}
+static inline bool scanElement(CDC_fileSyntax syntax, const char * line, int length,
+                               CDC_structuralCommand &command, CDC_docStructuralElement &element) {
+    QString decoded;
+    if(!scanUtf8Line(syntax, line, length, command, &decoded))
+        return false;
+    if(!decoded.isEmpty()) {
+        element.tag  = decoded.mid(command.tagStart,  command.tagLength);
+        element.name = decoded.mid(command.nameStart, command.nameLength);
+    }
+    else {
+        element.tag  = QString::fromLatin1(line + command.tagStart,  command.tagLength);
+        element.name = QString::fromLatin1(line + command.nameStart, command.nameLength);
+    }
+    element.index = command.index;
+    return true;
+}
+
+/// Implementation of inputFileParser::extractStructure() for both character types.
+template <typename T>
+static bool extractLines(CDC_fileSyntax syntax, const T * data, qint64 length,
+                         QList<CDC_docStructuralElement> &elements) {
+    bool retval = false;
+    CDC_docStructuralElementType deepest = CDC_docStructuralElementType::document; // idle
+    CDC_structuralCommand command;
+    CDC_docStructuralElement currSE;
+
+    qint64 lineStart = 0;
+    qint64 lineEnd;
+    int lineLength;
+    int currLine = 0;
+
+    elements.clear();
+
+    // Run parsing FSM
+    // For doxyen, only the first occurrance of a structural tag in a line is taken into account
+    // Also, one cannot jump directly into a daughter element without its parent: an element is only
+    // accepted if it is at most one level deeper than the last accepted one.
+    while(lineStart < length) {
+        currLine++;
+        lineEnd = findNewline(data, lineStart, length);
+        if(lineEnd == -1)
+            lineEnd = length;
+        lineLength = static_cast<int>(lineEnd - lineStart);
+        if(lineLength > 0 && isAsciiChar(data[lineEnd-1], '\r'))
+            lineLength--;
+
+        if(scanElement(syntax, data + lineStart, lineLength, command, currSE)
+                && static_cast<int>(command.type) <= static_cast<int>(deepest) + 1) {
+            currSE.line  = currLine;
+            currSE.type  = command.type;
+            elements.append(currSE);
+
+            deepest = command.type;
+            if(command.type == CDC_docStructuralElementType::section)
+                retval = true;
+        }
+        lineStart = lineEnd + 1;
+    }
+    return retval;
+}
+
 /**************************************** CONSTRUCTOR *******************************************/
 inputFileParser::inputFileParser(QObject *parent) :
     QObject(parent),
-    structure(new QStandardItemModel)
+    structure(new QStandardItemModel),
+    syntax(CDC_fileSyntax::none)
 {
 }
 
@@ -35,69 +243,60 @@ inputFileParser::~inputFileParser()
 
 bool inputFileParser::parseInputFile(QFile *ifile) {
     currentInputFile = ifile;
-    if(!currentInputFile->open(QFile::ReadOnly | QFile::Text))
+    currentIFContents.clear(); // contents are never decoded on this path
+    if(!extractStructure(syntax, currentInputFile, structureList))
         return false;
-    QTextStream in(currentInputFile);
-    currentIFContents = in.readAll();
-    currentInputFile->close();
-    return parseInputFile();
+
+    structure->clear();
+    structure->setColumnCount(1);
+    for (int i = 0; i < structureList.length(); ++i)
+        appendStructuralElement(structure->invisibleRootItem(), structureList[i], parentDocumentTag, indexOfCurrentFile);
+    return true;
 }
 
 bool inputFileParser::parseInputFile(QString ifcontents) {
     if(!ifcontents.isEmpty())
         currentIFContents = ifcontents;
 
-    bool retval = false;
-    QTextStream stream(&currentIFContents);
-    QString line;
-    CDC_pStates state = CDC_pStates::idle;
-
-    int index;
-    int currLine = 0;
+    bool retval = extractStructure(syntax, currentIFContents, structureList);
 
     structure->clear();
     structure->setColumnCount(1);
-    structureList.clear();
+    for (int i = 0; i < structureList.length(); ++i)
+        appendStructuralElement(structure->invisibleRootItem(), structureList[i], parentDocumentTag, indexOfCurrentFile);
+    return retval;
+}
 
-    // Run parsing FSM
-    // For doxyen, only the first occurrance of a structural tag in a line is taken into account
-    // Also, one cannot jump directly into a daughter element without its parent
-    while(!stream.atEnd()) {
-        currLine++;
-        line = stream.readLine();
-
-        // The lack of 'break' statements is on purpose
-        switch (state) {
-        case CDC_pStates::at_paragraph:
-        case CDC_pStates::at_subsubsection:
-            if(applySectionRuleOnLine(CDC_docStructuralElementType::paragraph,line,currLine)) {
-                state = CDC_pStates::at_paragraph;
-                break;
-            }
-
-        case CDC_pStates::at_subsection:
-            index = syntaxRules.subsubsection.indexIn(line);
-            if(applySectionRuleOnLine(CDC_docStructuralElementType::subsubsection,line,currLine)) {
-                state = CDC_pStates::at_subsubsection;
-                break;
-            }
-
-        case CDC_pStates::at_section:
-            if(applySectionRuleOnLine(CDC_docStructuralElementType::subsection,line,currLine)) {
-                state = CDC_pStates::at_subsection;
-                break;
-            }
-
-        case CDC_pStates::idle:
-            if(applySectionRuleOnLine(CDC_docStructuralElementType::section,line,currLine)) {
-                state = CDC_pStates::at_section;
-                retval = true; break;
-            }
-
-        default:
-            break;
-        }
+bool inputFileParser::extractStructure(CDC_fileSyntax syntax, const QString &contents,
+                                       QList<CDC_docStructuralElement> &elements) {
+    return extractLines(syntax, contents.constData(), contents.length(), elements);
+}
+
+bool inputFileParser::extractStructure(CDC_fileSyntax syntax, const char * data, qint64 length,
+                                       QList<CDC_docStructuralElement> &elements) {
+    return extractLines(syntax, data, length, elements);
+}
+
+bool inputFileParser::extractStructure(CDC_fileSyntax syntax, QFile * ifile,
+                                       QList<CDC_docStructuralElement> &elements) {
+    elements.clear();
+    if(!ifile->open(QIODevice::ReadOnly)) {
+        qWarning() << QString(__FUNCTION__) << "Unable to open" << ifile->fileName();
+        return false;
     }
+    if(ifile->size() == 0) { // Nothing to map
+        ifile->close();
+        return false;
+    }
+    uchar * data = ifile->map(0, ifile->size());
+    if(data == NULL) {
+        qWarning() << QString(__FUNCTION__) << "Unable to map" << ifile->fileName();
+        ifile->close();
+        return false;
+    }
+    bool retval = extractLines(syntax, reinterpret_cast<const char *>(data), ifile->size(), elements);
+    ifile->unmap(data);
+    ifile->close();
     return retval;
 }
 
@@ -105,12 +304,6 @@ void inputFileParser::setSyntax(CDC_fileSyntax fsyntax) {
     switch (fsyntax) {
     case CDC_fileSyntax::doxygen:
             syntax = fsyntax;
-            syntaxRules.section.setPattern("(\\\\section)(\\s+)(\\w+)(\\s+)(.*)");
-            syntaxRules.subsection.setPattern("(\\\\subsection)(\\s+)(\\w+)(\\s+)(.*)");
-            syntaxRules.subsubsection.setPattern("(\\\\subsubsection)(\\s+)(\\w+)(\\s+)(.*)");
-            syntaxRules.paragraph.setPattern("(\\\\paragraph)(\\s+)(\\w+)(\\s+)(.*)");
-            syntaxRules.tagGroup  = 3;
-            syntaxRules.nameGroup = 5;
         break;
     case CDC_fileSyntax::none:
     default:
@@ -119,32 +312,37 @@ void inputFileParser::setSyntax(CDC_fileSyntax fsyntax) {
     }
 }
 
-bool inputFileParser::applySectionRuleOnLine(CDC_docStructuralElementType type, QString line, int currLine) {
-    QRegExp regexp;
+bool inputFileParser::scanStructuralCommand(CDC_fileSyntax syntax, const QChar * line, int length,
+                                            CDC_structuralCommand &command) {
+    return scanLine(syntax, line, length, command);
+}
+
+bool inputFileParser::scanStructuralCommand(CDC_fileSyntax syntax, const char * line, int length,
+                                            CDC_structuralCommand &command) {
+    return scanUtf8Line(syntax, line, length, command);
+}
+
+bool inputFileParser::appendStructuralElement(QStandardItem * rootItem, const CDC_docStructuralElement &element,
+                                              const QString &docTag, int fileIndex) {
     QString tooltip;
     int depth;
-    CDC_docStructuralElement currSE;
     QStandardItem *  newItem;
     QStandardItem *  parentItem;
 
-    switch (type) {
+    switch (element.type) {
     case CDC_docStructuralElementType::section:
-            regexp = syntaxRules.section;
             tooltip = "Section tag: ";
             depth = 0;
         break;
     case CDC_docStructuralElementType::subsection:
-            regexp = syntaxRules.subsection;
             tooltip = "Subsection tag: ";
             depth = 1;
         break;
     case CDC_docStructuralElementType::subsubsection:
-            regexp = syntaxRules.subsubsection;
             tooltip = "Subsubsection tag: ";
             depth = 2;
         break;
     case CDC_docStructuralElementType::paragraph:
-            regexp = syntaxRules.paragraph;
             tooltip = "Paragraph tag: ";
             depth = 3;
         break;
@@ -153,34 +351,27 @@ bool inputFileParser::applySectionRuleOnLine(CDC_docStructuralElementType type,
         break;
     }
 
-    int index = regexp.indexIn(line);
-    if(index >= 0) {
-        currSE.tag  = regexp.cap(syntaxRules.tagGroup );
-        currSE.name = regexp.cap(syntaxRules.nameGroup);
-
-        newItem = new QStandardItem(currSE.name);
-        newItem->setData(QVariant(currSE.tag), CDC_docStructuralElementRole::Tag );
-        newItem->setData(QVariant(currLine),   CDC_docStructuralElementRole::Line);
-        newItem->setData(QVariant(static_cast<int>(type)), CDC_docStructuralElementRole::Type);
-        newItem->setData(QVariant(parentDocumentTag),      CDC_docStructuralElementRole::Doc);
-        newItem->setData(QVariant(indexOfCurrentFile),     CDC_docStructuralElementRole::Index);
-        newItem->setEditable(false);
-        newItem->setToolTip(tooltip + currSE.tag);
-
-        parentItem = structure->invisibleRootItem();
-        while(depth) {
-            if(parentItem->hasChildren())
-                parentItem = parentItem->child(parentItem->rowCount()-1);
-            else {
-                qDebug() << QString(__FUNCTION__)
-                         << "Unable to append structural element" << currSE.tag << "to document's struture!";
-                return false;
-            }
-            depth--;
+    parentItem = rootItem;
+    while(depth) {
+        if(parentItem->hasChildren())
+            parentItem = parentItem->child(parentItem->rowCount()-1);
+        else {
+            qDebug() << QString(__FUNCTION__)
+                     << "Unable to append structural element" << element.tag << "to document's struture!";
+            return false;
         }
-        parentItem->appendRow(newItem);
-        //std::cout << "Found " << QString(tooltip + currSE.tag).toStdString() << std::endl;
-        return true;
+        depth--;
     }
-    else return false;
+
+    newItem = new QStandardItem(element.name);
+    newItem->setData(QVariant(element.tag),  CDC_docStructuralElementRole::Tag );
+    newItem->setData(QVariant(element.line), CDC_docStructuralElementRole::Line);
+    newItem->setData(QVariant(static_cast<int>(element.type)), CDC_docStructuralElementRole::Type);
+    newItem->setData(QVariant(docTag),       CDC_docStructuralElementRole::Doc);
+    newItem->setData(QVariant(fileIndex),    CDC_docStructuralElementRole::Index);
+    newItem->setEditable(false);
+    newItem->setToolTip(tooltip + element.tag);
+
+    parentItem->appendRow(newItem);
+    return true;
 }
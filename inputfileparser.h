@@ -48,7 +48,8 @@ public:
     /**
      * @brief parseInputFile
      * @param ifile
-     * @return The result of parseInputFile() on the \b QString contents of the file.
+     * @return Whether any kind of structural element was found in the file. The file is scanned through
+     * a memory map (see extractStructure() ), so its contents are not kept by the parser.
      */
     bool parseInputFile(QFile * ifile);
 
@@ -68,6 +69,68 @@ public:
     int  getIndexOfCurrentFile()                 { return indexOfCurrentFile;  }
     void setIndexOfCurrentFile(const int &value) { indexOfCurrentFile = value; }
 
+    /**
+     * @brief Creates the tree item for \em element and appends it under \em rootItem.
+     * The parent is found by descending through the last child of each level, according to the
+     * element's type (a subsection goes under the last section, and so on).
+     * Shared by the parser and by documentWorker, which rebuilds the tree out of cached element lists.
+     * @param rootItem Item that stands for the document (or file) root.
+     * @param element Structural element to be appended.
+     * @param docTag Tag of the parent document, stored in the CDC_docStructuralElementRole::Doc role.
+     * @param fileIndex Index of the input file in the parent document's IFlist.
+     * @return Whether the element could be appended (its parent element exists).
+     */
+    static bool appendStructuralElement(QStandardItem * rootItem, const CDC_docStructuralElement &element,
+                                        const QString &docTag, int fileIndex);
+
+    /**
+     * @brief Looks for the first structural command of \em syntax in a single line.
+     * Single pass over the line: every backslash is checked against the syntax's keyword table, and the
+     * command is only accepted if followed by whitespace, a tag (word characters), whitespace and a name.
+     * Nothing gets allocated: only the spans are stored in \em command. Used by the parser and, per
+     * block, by cdcHighlighter::highlightBlock() .
+     * @param syntax Syntax whose keyword table will be used.
+     * @param line Pointer to the first character of the line (no line terminator).
+     * @param length Number of characters in the line.
+     * @param command Receives the spans of the command, if one is found.
+     * @return Whether a structural command was found in the line.
+     */
+    static bool scanStructuralCommand(CDC_fileSyntax syntax, const QChar * line, int length,
+                                      CDC_structuralCommand &command);
+
+    /**
+     * @brief Overloads scanStructuralCommand() for UTF-8 encoded lines.
+     * Lines with non-ASCII characters are decoded before being scanned, so the result (spans included,
+     * given in UTF-16 code units) is the same as scanning the decoded line.
+     */
+    static bool scanStructuralCommand(CDC_fileSyntax syntax, const char * line, int length,
+                                      CDC_structuralCommand &command);
+
+    /**
+     * @brief Runs the parsing FSM over \em contents, producing a flat list of structural elements.
+     * Touches no parser state nor any model item, so it can be safely called from worker threads.
+     * The elements are listed in file order, and each one is at most one level deeper than the one
+     * before it, so they can later be turned into a tree with appendStructuralElement() .
+     * @param syntax Syntax of the contents.
+     * @param contents Plain-text contents of the input file.
+     * @param elements Receives the structural elements found (previous contents are discarded).
+     * @return Whether any section was found.
+     */
+    static bool extractStructure(CDC_fileSyntax syntax, const QString &contents,
+                                 QList<CDC_docStructuralElement> &elements);
+
+    /// \brief Overloads extractStructure() for UTF-8 encoded contents. Only tags and names get decoded.
+    static bool extractStructure(CDC_fileSyntax syntax, const char * data, qint64 length,
+                                 QList<CDC_docStructuralElement> &elements);
+
+    /**
+     * @brief Overloads extractStructure() to work straight from a (UTF-8) file.
+     * The file is memory-mapped and scanned in place, so its contents are never copied nor decoded.
+     * @return Whether any section was found. FALSE also if the file couldn't be opened.
+     */
+    static bool extractStructure(CDC_fileSyntax syntax, QFile * ifile,
+                                 QList<CDC_docStructuralElement> &elements);
+
 private:
     QStandardItemModel * structure; /// Structure of the input file (sections, subsecions...)
 
@@ -76,39 +139,11 @@ private:
     CDC_buildEngine buidEngine;
     CDC_fileSyntax  syntax;
 
-    struct {
-        QRegExp section;
-        QRegExp subsection;
-        QRegExp subsubsection;
-        QRegExp paragraph;
-        int tagGroup;
-        int nameGroup;
-    } syntaxRules;
-
     QFile * currentInputFile;  /// Handle to the current input file
     QString currentIFContents; /// Current active input file's contents
     QString parentDocumentTag; /// Tag of the parent document of the file being parsed
     int indexOfCurrentFile;    /// Holds the index of the curr IF in the parent document's IFlist
 
-    /// States for the parsing state machine
-    enum class CDC_pStates {
-        idle,               //! Didn't find anything
-        at_section,         //! Found a section header. Will append subsections to it, if any
-        at_subsection,      //! Found a subsection header. Will append subsubsections to it, if any
-        at_subsubsection,   //! Found a subsubsection header. Will append paragraphs to it, if any
-        at_paragraph        //! Found a paragraph header
-    };
-
-    // Methods
-
-    /**
-     * @brief applySectionRuleOnLine
-     * @param type
-     * @param line
-     * @return If the desired section was found in that particular line.
-     */
-    bool applySectionRuleOnLine(CDC_docStructuralElementType type, QString line, int currLine);
-
 signals:
 
 public slots:
@@ -0,0 +1,180 @@
+/**
+  *****************************************************************************
+  *  _____                  ______
+  * /  __ \                 |  _  \
+  * | /  \/_ __ ___  ___ ___| | | |___   ___ ___
+  * | |   | '__/ _ \/ __/ __| | | / _ \ / __/ __|
+  * | \__/\ | | |_| \__ \__ \ |/ / |_| | (__\__ \
+  *  \____/_|  \___/|___/___/___/ \___/ \___|___/
+  *
+  *****************************************************************************
+  *
+  * @file    logmodel.cpp
+  * @author  Martin Vincent Bloedorn
+  * @version V0.1.0
+  * @date    17-October-2026
+  * @brief   Bounded list model behind the GUI's log console.
+**/
+
+#include "logmodel.h"
+
+// Messages kept by default, and how long messages wait to be handed to the views (about a frame)
+const int defaultRetention = 10000;
+const int flushIntervalMs  = 16;
+
+/**************************************** CONSTRUCTOR *******************************************/
+logModel::logModel(QObject *parent) :
+    QAbstractListModel(parent),
+    firstSeq(0),
+    endSeq(0),
+    retention(defaultRetention),
+    minimumSeverity(QtDebugMsg),
+    flushScheduled(false)
+{
+    flushTimer = new QTimer(this);
+    flushTimer->setSingleShot(true);
+    flushTimer->setInterval(flushIntervalMs);
+    connect(flushTimer, SIGNAL(timeout()), this, SLOT(flushPending()));
+}
+
+logModel::~logModel() {
+}
+
+/**************************************** METHODS ***********************************************/
+int logModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rows.size();
+}
+
+QVariant logModel::data(const QModelIndex &index, int role) const {
+    if(!index.isValid() || index.row() >= rows.size())
+        return QVariant();
+    const CDC_logEntry &entry = entries[static_cast<int>(rows[index.row()] % retention)];
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return QDateTime::fromMSecsSinceEpoch(entry.time).toString("hh.mm.ss.zzz")
+                + (entry.type == QtFatalMsg ? " FATAL: " : ": ") + entry.text;
+    case Qt::ForegroundRole:
+        switch (entry.type) {
+        case QtWarningMsg:  return QColor(255,150,0);
+        case QtCriticalMsg:
+        case QtFatalMsg:    return QColor(Qt::red);
+        default:            return QVariant();
+        }
+    default:
+        return QVariant();
+    }
+}
+
+void logModel::append(QtMsgType type, const QString &text) {
+    CDC_logEntry entry;
+    entry.time = QDateTime::currentMSecsSinceEpoch();
+    entry.type = type;
+    entry.text = text;
+
+    QMutexLocker locker(&pendingMutex);
+    pending.append(entry);
+    if(!flushScheduled) {
+        flushScheduled = true;
+        // The timer belongs to the model's thread, which may not be the caller's
+        QMetaObject::invokeMethod(flushTimer, "start", Qt::QueuedConnection);
+    }
+}
+
+void logModel::clear() {
+    beginResetModel();
+    entries.clear();
+    rows.clear();
+    firstSeq = 0;
+    endSeq   = 0;
+    endResetModel();
+}
+
+void logModel::setMinimumSeverity(QtMsgType type) {
+    if(type == minimumSeverity)
+        return;
+    beginResetModel();
+    minimumSeverity = type;
+    rebuildRows();
+    endResetModel();
+}
+
+void logModel::setRetention(int value) {
+    value = qMax(1, value);
+    if(value == retention)
+        return;
+    beginResetModel();
+    // Keep the newest messages, renumbered from 0 so they land in order in the new ring
+    QVector<CDC_logEntry> kept;
+    qint64 from = qMax(firstSeq, endSeq - value);
+    kept.reserve(static_cast<int>(endSeq - from));
+    for (qint64 seq = from; seq < endSeq; ++seq)
+        kept.append(entries[static_cast<int>(seq % retention)]);
+    entries  = kept;
+    firstSeq = 0;
+    endSeq   = kept.size();
+    retention = value;
+    rebuildRows();
+    endResetModel();
+}
+
+// PRIVATE ------------------------------------------------------------------------
+void logModel::rebuildRows() {
+    rows.clear();
+    int minimum = severity(minimumSeverity);
+    for (qint64 seq = firstSeq; seq < endSeq; ++seq)
+        if(severity(entries[static_cast<int>(seq % retention)].type) >= minimum)
+            rows.append(seq);
+}
+
+int logModel::severity(QtMsgType type) {
+    switch (type) {
+    case QtWarningMsg:  return 2;
+    case QtCriticalMsg: return 3;
+    case QtFatalMsg:    return 4;
+    case QtDebugMsg:    return 0;
+    default:            return 1; // QtInfoMsg, on Qt versions that have it
+    }
+}
+
+void logModel::flushPending() {
+    QVector<CDC_logEntry> batch;
+    pendingMutex.lock();
+    batch.swap(pending);
+    flushScheduled = false;
+    pendingMutex.unlock();
+    if(batch.isEmpty())
+        return;
+
+    // Messages that would be evicted by this same batch are never shown
+    int skip = qMax(0, batch.size() - retention);
+
+    // Make room first: drop the oldest messages, and the rows showing them
+    qint64 evictEnd = qMax(firstSeq, endSeq + (batch.size() - skip) - retention);
+    int evictedRows = 0;
+    while(evictedRows < rows.size() && rows[evictedRows] < evictEnd)
+        evictedRows++;
+    if(evictedRows > 0) {
+        beginRemoveRows(QModelIndex(), 0, evictedRows - 1);
+        rows.erase(rows.begin(), rows.begin() + evictedRows);
+        endRemoveRows();
+    }
+    firstSeq = evictEnd;
+
+    QList<qint64> added;
+    int minimum = severity(minimumSeverity);
+    for (int i = skip; i < batch.size(); ++i) {
+        qint64 seq = endSeq++;
+        if(entries.size() < retention)
+            entries.append(batch[i]);
+        else
+            entries[static_cast<int>(seq % retention)] = batch[i];
+        if(severity(batch[i].type) >= minimum)
+            added.append(seq);
+    }
+    if(!added.isEmpty()) {
+        beginInsertRows(QModelIndex(), rows.size(), rows.size() + added.size() - 1);
+        rows.append(added);
+        endInsertRows();
+    }
+}
@@ -0,0 +1,92 @@
+/**
+  *****************************************************************************
+  *  _____                  ______
+  * /  __ \                 |  _  \
+  * | /  \/_ __ ___  ___ ___| | | |___   ___ ___
+  * | |   | '__/ _ \/ __/ __| | | / _ \ / __/ __|
+  * | \__/\ | | |_| \__ \__ \ |/ / |_| | (__\__ \
+  *  \____/_|  \___/|___/___/___/ \___/ \___|___/
+  *
+  *****************************************************************************
+  *
+  * @file    logmodel.h
+  * @author  Martin Vincent Bloedorn
+  * @version V0.1.0
+  * @date    17-October-2026
+  * @brief   Bounded list model behind the GUI's log console.
+**/
+
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QVector>
+#include <QList>
+#include <QMutex>
+#include <QTimer>
+#include <QDateTime>
+#include <QColor>
+
+/**
+ * @brief List model of log messages, kept in a ring buffer of at most getRetention() entries.
+ * Messages can be appended from any thread: they are queued and handed to the views in one batch per
+ * frame (one row insertion, and at most one removal of evicted rows). Only messages at or above
+ * getMinimumSeverity() are shown. Display text and colors are computed when requested, so a message
+ * costs one small struct until it is actually painted.
+ */
+class logModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    logModel(QObject *parent = 0);
+    ~logModel();
+
+    // QAbstractItemModel interface
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+
+    /// \brief Queues a message. Thread-safe; it shows up in the views within a frame.
+    void append(QtMsgType type, const QString &text);
+
+    QtMsgType getMinimumSeverity() { return minimumSeverity; }
+    void setMinimumSeverity(QtMsgType type);
+
+    /// \brief Maximum number of messages kept; the oldest ones are dropped first.
+    int  getRetention() { return retention; }
+    void setRetention(int value);
+
+public slots:
+    /// \brief Removes all messages (resets the model).
+    void clear();
+
+private:
+    typedef struct {
+        qint64 time;                /// Milliseconds since epoch
+        QtMsgType type;
+        QString text;
+    } CDC_logEntry;
+
+    // Message n (counted since the last reset) is at entries[n % retention]
+    QVector<CDC_logEntry> entries;
+    qint64 firstSeq;                /// Oldest message still kept
+    qint64 endSeq;                  /// One past the newest message
+    QList<qint64> rows;             /// Messages shown, one per row (those passing minimumSeverity)
+    int retention;
+    QtMsgType minimumSeverity;
+
+    QMutex pendingMutex;            /// Guards pending and flushScheduled
+    QVector<CDC_logEntry> pending;  /// Messages not handed to the views yet
+    bool flushScheduled;
+    QTimer * flushTimer;
+
+    /// \brief Rebuilds rows from the kept messages. Only between beginResetModel() and endResetModel() .
+    void rebuildRows();
+
+    /// \brief Orders severities (QtMsgType values don't: debug is 0, but info comes after fatal).
+    static int severity(QtMsgType type);
+
+private slots:
+    void flushPending();
+};
+
+#endif // LOGMODEL_H
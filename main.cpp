@@ -28,9 +28,10 @@
 cdcMainWindow * mainWindow;
 
 /// \brief Wrapper for cdcMainWindow::messageHandler , to use with qInstallMessageHandler .
+/// The log console queues messages itself, so this is safe to call from any thread.
 void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg) {
-    QByteArray ba = msg.toLocal8Bit();
-    mainWindow->messageHandler(type, ba.constData(), false);
+    Q_UNUSED(context);
+    mainWindow->logMessage(static_cast<int>(type), msg);
 }
 
 int main(int argc, char * argv[])
@@ -44,10 +45,9 @@ int main(int argc, char * argv[])
 
     mainWindow->show();
     qDebug() << "CrossDocs GUI started sucessfully!";
-    mainWindow->openProject("/Users/martin/Workspaces/qt/crossdocs_gui/cdc_test/testconf.cdc");
 
-    //if(argc > 1)
-        //mainWindow->openProject(argv[1]);
+    if(argc > 1)
+        mainWindow->openProject(argv[1]);
 
     //inputFileParser * ifparser = new inputFileParser();
     //ifparser->setSyntax(CDC_fileSyntax::doxygen);
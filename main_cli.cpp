@@ -0,0 +1,220 @@
+/**
+  *****************************************************************************
+  *  _____                  ______
+  * /  __ \                 |  _  \
+  * | /  \/_ __ ___  ___ ___| | | |___   ___ ___
+  * | |   | '__/ _ \/ __/ __| | | / _ \ / __/ __|
+  * | \__/\ | | |_| \__ \__ \ |/ / |_| | (__\__ \
+  *  \____/_|  \___/|___/___/___/ \___/ \___|___/
+  *
+  *****************************************************************************
+  *
+  * @file    main_cli.cpp
+  * @author  Martin Vincent Bloedorn
+  * @version V0.1.0
+  * @date    17-October-2026
+  * @brief   CrossDocs command line entry point (no GUI, for batch/CI use).
+  *
+  * Usage:
+  * \code
+  *     crossdocs_cli [--verbose] [--no-build] project.cdc
+  *     crossdocs_cli --bench-config <count> project.cdc
+  *     crossdocs_cli --bench-structure <file.cdp>
+  * \endcode
+  * Exit codes: 0 if everything went ok, 1 on bad arguments, 2 if the project could not be
+  * configured and 3 if the build failed.
+**/
+
+#include <iostream>
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QRegExp>
+#include <QDebug>
+
+#include "projectworker.h"
+#include "configurationfileparser.h"
+#include "inputfileparser.h"
+
+bool verbose = false;
+
+/// \brief Drops debug messages unless --verbose was given. Everything else goes to stderr.
+void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg) {
+    Q_UNUSED(context);
+    if(type == QtDebugMsg && !verbose)
+        return;
+    std::cerr << msg.toLocal8Bit().constData() << std::endl;
+}
+
+/// \brief Prints the time taken by one of the phases.
+void printPhase(const char * phase, QElapsedTimer &timer) {
+    std::cout << phase << ": " << timer.restart() << " ms" << std::endl;
+}
+
+/**
+ * @brief Microbenchmark of configurationFileParser: parses the project's cdc file and the cdd files
+ * of its documents, round-robin, until \em count files have been parsed.
+ * @return Whether all files were parsed.
+ */
+bool benchConfigurationParser(QString prjconffile, int count) {
+    configurationFileParser fp;
+    QStringList files(prjconffile);
+    if(!fp.parseFile(prjconffile))
+        return false;
+    QString basePath = QFileInfo(prjconffile).absolutePath() + "/";
+    QStringList documents = fp.getSectionContents("documents");
+    for (int i = 0; i < documents.length(); ++i)
+        files.append(basePath + documents[i]);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count; ++i)
+        if(!fp.parseFile(files[i % files.length()]))
+            return false;
+    qint64 elapsed = timer.nsecsElapsed();
+
+    std::cout << "config: " << count << " files in " << elapsed / 1000000 << " ms ("
+              << (count > 0 ? elapsed / 1000 / count : 0) << " us/file)" << std::endl;
+    return true;
+}
+
+/// Size the input file is repeated up to, so the structure benchmark runs over a multi-MB corpus
+const int benchCorpusBytes = 16 * 1024 * 1024;
+
+/// \brief Prints the time taken to scan \em lines lines (\em bytes bytes) and the resulting throughput.
+void printScanner(const char * scanner, qint64 nsecs, int lines, qint64 bytes, int elements) {
+    double seconds = nsecs / 1e9;
+    std::cout << scanner << ": " << nsecs / 1000000 << " ms, "
+              << static_cast<qint64>(seconds > 0 ? lines / seconds : 0) << " lines/s, "
+              << static_cast<qint64>(seconds > 0 ? bytes / seconds / (1024 * 1024) : 0) << " MB/s ("
+              << elements << " elements)" << std::endl;
+}
+
+/**
+ * @brief Microbenchmark of the structure scanners: times the former per-line QRegExp passes against
+ * inputFileParser::extractStructure() (on decoded text and on UTF-8 bytes), over the contents of
+ * \em inputfile repeated up to benchCorpusBytes .
+ * @return Whether the file could be read.
+ */
+bool benchStructureScanner(QString inputfile) {
+    QFile file(inputfile);
+    if(!file.open(QIODevice::ReadOnly)) {
+        std::cerr << "Unable to open " << inputfile.toLocal8Bit().constData() << std::endl;
+        return false;
+    }
+    QByteArray bytes = file.readAll();
+    if(bytes.isEmpty())
+        return false;
+    if(!bytes.endsWith('\n'))
+        bytes.append('\n');
+    QByteArray corpus;
+    corpus.reserve(benchCorpusBytes + bytes.size());
+    while(corpus.size() < benchCorpusBytes)
+        corpus.append(bytes);
+    QString text = QString::fromUtf8(corpus);
+    int lines = corpus.count('\n');
+    std::cout << "corpus: " << corpus.size() / 1024 << " KB, " << lines << " lines" << std::endl;
+
+    QElapsedTimer timer;
+    QList<CDC_docStructuralElement> elements;
+
+    // Former scanner: QTextStream::readLine(), then one regexp per structural command until one matches
+    QList<QRegExp> rules;
+    rules << QRegExp("(\\\\section)(\\s+)(\\w+)(\\s+)(.*)")
+          << QRegExp("(\\\\subsection)(\\s+)(\\w+)(\\s+)(.*)")
+          << QRegExp("(\\\\subsubsection)(\\s+)(\\w+)(\\s+)(.*)")
+          << QRegExp("(\\\\paragraph)(\\s+)(\\w+)(\\s+)(.*)");
+    int found = 0;
+    timer.start();
+    QTextStream stream(&text);
+    while(!stream.atEnd()) {
+        QString line = stream.readLine();
+        for (int i = 0; i < rules.length(); ++i) {
+            if(rules[i].indexIn(line) >= 0) {
+                QString tag  = rules[i].cap(3);
+                QString name = rules[i].cap(5);
+                found++;
+                break;
+            }
+        }
+    }
+    printScanner("regexp", timer.nsecsElapsed(), lines, corpus.size(), found);
+
+    timer.restart();
+    inputFileParser::extractStructure(CDC_fileSyntax::doxygen, text, elements);
+    printScanner("scanner (QString)", timer.nsecsElapsed(), lines, corpus.size(), elements.length());
+
+    timer.restart();
+    inputFileParser::extractStructure(CDC_fileSyntax::doxygen, corpus.constData(), corpus.size(), elements);
+    printScanner("scanner (UTF-8)", timer.nsecsElapsed(), lines, corpus.size(), elements.length());
+    return true;
+}
+
+int main(int argc, char * argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("crossdocs_cli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Configures, checks and builds a CrossDocs project.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("project", "Project configuration file (*.cdc).");
+    QCommandLineOption verboseOption(QStringList() << "v" << "verbose", "Print debug messages.");
+    QCommandLineOption noBuildOption("no-build", "Only configure the project and extract its structure.");
+    QCommandLineOption benchConfigOption("bench-config", "Only time the parsing of <count> configuration files "
+                                         "(the project's own files, over and over).", "count", "10000");
+    parser.addOption(verboseOption);
+    parser.addOption(noBuildOption);
+    QCommandLineOption benchStructureOption("bench-structure", "Only time the structure scanners (former "
+                                            "regexps and current one) over <file> , repeated up to 16 MB.", "file");
+    parser.addOption(benchConfigOption);
+    parser.addOption(benchStructureOption);
+    parser.process(app);
+
+    if(parser.isSet(benchStructureOption))
+        return benchStructureScanner(parser.value(benchStructureOption)) ? 0 : 2;
+
+    if(parser.positionalArguments().length() != 1) {
+        std::cerr << parser.helpText().toLocal8Bit().constData();
+        return 1;
+    }
+    verbose = parser.isSet(verboseOption);
+    qInstallMessageHandler(messageHandler);
+
+    QString prjconffile = parser.positionalArguments()[0];
+    if(parser.isSet(benchConfigOption))
+        return benchConfigurationParser(prjconffile, parser.value(benchConfigOption).toInt()) ? 0 : 2;
+
+    CDC_status status = CDC_status::ok;
+    projectWorker pw;
+    QElapsedTimer timer;
+    timer.start();
+
+    if(!pw.configureProject(prjconffile, &status)) {
+        std::cerr << "Failed to configure " << prjconffile.toLocal8Bit().constData() << std::endl;
+        return 2;
+    }
+    printPhase("configure", timer);
+
+    int count = pw.extractProjectStructure();
+    printPhase("structure", timer);
+    std::cout << pw.getDocumentTagList().length() << " documents, "
+              << count << " structural elements" << std::endl;
+
+    if(!parser.isSet(noBuildOption)) {
+        QObject::connect(&pw, &projectWorker::buildOutput, [](QString doctag, QString line, bool isError) {
+            (isError ? std::cerr : std::cout) << "[" << doctag.toLocal8Bit().constData() << "] "
+                                              << line.toLocal8Bit().constData() << std::endl;
+        });
+        if(!pw.build(QString(), &status)) {
+            std::cerr << "Build failed" << std::endl;
+            return 3;
+        }
+        printPhase("build", timer);
+    }
+
+    return 0;
+}
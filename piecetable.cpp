@@ -0,0 +1,273 @@
+/**
+  *****************************************************************************
+  *  _____                  ______
+  * /  __ \                 |  _  \
+  * | /  \/_ __ ___  ___ ___| | | |___   ___ ___
+  * | |   | '__/ _ \/ __/ __| | | / _ \ / __/ __|
+  * | \__/\ | | |_| \__ \__ \ |/ / |_| | (__\__ \
+  *  \____/_|  \___/|___/___/___/ \___/ \___|___/
+  *
+  *****************************************************************************
+  *
+  * @file    piecetable.cpp
+  * @author  Martin Vincent Bloedorn
+  * @version V0.1.0
+  * @date    17-October-2026
+  * @brief   Piece table holding the text of an input file.
+**/
+
+#include "piecetable.h"
+
+#include <cstring>
+
+// Characters reserved per add chunk. Insertions bigger than a quarter of it get a chunk of their own.
+const int addChunkSize   = 64 * 1024;
+// Characters encoded at once by write()
+const int writeBlockSize = 64 * 1024;
+
+/**************************************** CONSTRUCTOR *******************************************/
+pieceTable::pieceTable() :
+    seed(0x9E3779B9)
+{
+}
+
+pieceTable::pieceTable(const QString &text) :
+    original(new QString(text)),
+    seed(0x9E3779B9)
+{
+    if(!text.isEmpty()) {
+        CDC_piece piece;
+        piece.source = original;
+        piece.start  = 0;
+        piece.length = text.length();
+        root = makeNode(piece, CDC_pieceNodePtr(), CDC_pieceNodePtr(), nextPriority());
+    }
+}
+
+/**************************************** METHODS ***********************************************/
+template <typename F>
+bool pieceTable::visit(const CDC_pieceNodePtr &node, int position, int count, F f) {
+    if(node.isNull() || count <= 0)
+        return true;
+
+    int leftLength = lengthOf(node->left);
+    if(position < leftLength) {
+        int n = qMin(count, leftLength - position);
+        if(!visit(node->left, position, n, f))
+            return false;
+        position += n;
+        count    -= n;
+    }
+    position -= leftLength; // from here on, relative to this node's piece
+    if(count > 0 && position < node->piece.length) {
+        int n = qMin(count, node->piece.length - position);
+        if(!f(node->piece.source->constData() + node->piece.start + position, n))
+            return false;
+        position += n;
+        count    -= n;
+    }
+    return visit(node->right, position - node->piece.length, count, f);
+}
+
+int pieceTable::length() const {
+    return lengthOf(root);
+}
+
+void pieceTable::insert(int position, const QString &text) {
+    if(text.isEmpty())
+        return;
+    position = qBound(0, position, length());
+
+    CDC_pieceNodePtr left, right;
+    split(root, position, left, right);
+    CDC_piece piece = appendText(text);
+
+    // Typing lands right after the previous insertion in the add chunk: grow that piece instead
+    const CDC_piece * last = lastPiece(left);
+    if(last != NULL && last->source == piece.source && last->start + last->length == piece.start)
+        left = extendLast(left, piece.length);
+    else
+        left = merge(left, makeNode(piece, CDC_pieceNodePtr(), CDC_pieceNodePtr(), nextPriority()));
+    root = merge(left, right);
+}
+
+void pieceTable::remove(int position, int count) {
+    position = qBound(0, position, length());
+    count    = qBound(0, count, length() - position);
+    if(count == 0)
+        return;
+
+    CDC_pieceNodePtr left, rest, removed, right;
+    split(root, position, left, rest);
+    split(rest, count, removed, right);
+    root = merge(left, right);
+}
+
+void pieceTable::replace(int position, int count, const QString &text) {
+    remove(position, count);
+    insert(position, text);
+}
+
+QString pieceTable::toString() const {
+    if(root.isNull())
+        return QString("");
+    if(root->count == 1 && root->piece.source == original && root->piece.length == original->length())
+        return *original;
+
+    QString text;
+    text.reserve(root->length);
+    visit(root, 0, root->length, [&text](const QChar * data, int n) {
+        text.append(data, n);
+        return true;
+    });
+    return text;
+}
+
+QString pieceTable::mid(int position, int count) const {
+    position = qBound(0, position, length());
+    count    = qBound(0, count, length() - position);
+
+    QString text;
+    text.reserve(count);
+    visit(root, position, count, [&text](const QChar * data, int n) {
+        text.append(data, n);
+        return true;
+    });
+    return text;
+}
+
+bool pieceTable::equals(const QString &text) const {
+    if(text.length() != length())
+        return false;
+    const QChar * expected = text.constData();
+    return visit(root, 0, text.length(), [&expected](const QChar * data, int n) {
+        bool same = memcmp(data, expected, n * sizeof(QChar)) == 0;
+        expected += n;
+        return same;
+    });
+}
+
+bool pieceTable::write(QIODevice * device) const {
+    // Stateful encoder: a surrogate pair cut by a piece or block boundary is still encoded right
+    QTextEncoder * encoder = QTextCodec::codecForName("UTF-8")->makeEncoder(QTextCodec::IgnoreHeader);
+    bool retval = visit(root, 0, length(), [device, encoder](const QChar * data, int n) {
+        for (int done = 0; done < n; done += writeBlockSize) {
+            QByteArray block = encoder->fromUnicode(data + done, qMin(writeBlockSize, n - done));
+            if(device->write(block) != block.size())
+                return false;
+        }
+        return true;
+    });
+    delete encoder;
+    return retval;
+}
+
+int pieceTable::pieceCount() const {
+    return root.isNull() ? 0 : root->count;
+}
+
+// PRIVATE ------------------------------------------------------------------------
+pieceTable::CDC_piece pieceTable::appendText(const QString &text) {
+    CDC_piece piece;
+    piece.length = text.length();
+
+    if(text.length() > addChunkSize / 4) { // e.g. a paste: keep (share) the string as it is
+        piece.source = CDC_pieceSource(new QString(text));
+        piece.start  = 0;
+        return piece;
+    }
+    // Chunks are filled up to the capacity they were created with, and never copied as QStrings, so
+    // appending never reallocates them: snapshots on other threads keep reading their older parts.
+    if(addChunk.isNull() || addChunk->length() + text.length() > addChunk->capacity()) {
+        addChunk = CDC_pieceSource(new QString());
+        addChunk->reserve(addChunkSize);
+    }
+    piece.source = addChunk;
+    piece.start  = addChunk->length();
+    addChunk->append(text);
+    return piece;
+}
+
+quint32 pieceTable::nextPriority() {
+    // xorshift32
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+pieceTable::CDC_pieceNodePtr pieceTable::makeNode(const CDC_piece &piece, const CDC_pieceNodePtr &left,
+                                                  const CDC_pieceNodePtr &right, quint32 priority) {
+    CDC_pieceNode * node = new CDC_pieceNode;
+    node->piece    = piece;
+    node->left     = left;
+    node->right    = right;
+    node->length   = lengthOf(left) + piece.length + lengthOf(right);
+    node->count    = (left.isNull() ? 0 : left->count) + 1 + (right.isNull() ? 0 : right->count);
+    node->priority = priority;
+    return CDC_pieceNodePtr(node);
+}
+
+void pieceTable::split(const CDC_pieceNodePtr &node, int position, CDC_pieceNodePtr &left, CDC_pieceNodePtr &right) {
+    // Nodes are never changed: only the path down to position is copied
+    if(node.isNull() || position <= 0) {
+        left.clear();
+        right = node;
+        return;
+    }
+    if(position >= node->length) {
+        left = node;
+        right.clear();
+        return;
+    }
+
+    CDC_pieceNodePtr l, r;
+    int leftLength = lengthOf(node->left);
+    int inPiece    = position - leftLength;
+    if(inPiece <= 0) {
+        split(node->left, position, l, r);
+        left  = l;
+        right = makeNode(node->piece, r, node->right, node->priority);
+    }
+    else if(inPiece >= node->piece.length) {
+        split(node->right, inPiece - node->piece.length, l, r);
+        left  = makeNode(node->piece, node->left, l, node->priority);
+        right = r;
+    }
+    else { // Cut the piece itself in two
+        CDC_piece head = node->piece;
+        CDC_piece tail = node->piece;
+        head.length  = inPiece;
+        tail.start  += inPiece;
+        tail.length -= inPiece;
+        left  = makeNode(head, node->left, CDC_pieceNodePtr(), node->priority);
+        right = makeNode(tail, CDC_pieceNodePtr(), node->right, node->priority);
+    }
+}
+
+pieceTable::CDC_pieceNodePtr pieceTable::merge(const CDC_pieceNodePtr &left, const CDC_pieceNodePtr &right) {
+    if(left.isNull())
+        return right;
+    if(right.isNull())
+        return left;
+    if(left->priority >= right->priority)
+        return makeNode(left->piece, left->left, merge(left->right, right), left->priority);
+    return makeNode(right->piece, merge(left, right->left), right->right, right->priority);
+}
+
+pieceTable::CDC_pieceNodePtr pieceTable::extendLast(const CDC_pieceNodePtr &node, int count) {
+    if(!node->right.isNull())
+        return makeNode(node->piece, node->left, extendLast(node->right, count), node->priority);
+    CDC_piece piece = node->piece;
+    piece.length += count;
+    return makeNode(piece, node->left, CDC_pieceNodePtr(), node->priority);
+}
+
+const pieceTable::CDC_piece * pieceTable::lastPiece(const CDC_pieceNodePtr &node) {
+    if(node.isNull())
+        return NULL;
+    const CDC_pieceNode * n = node.data();
+    while(!n->right.isNull())
+        n = n->right.data();
+    return &n->piece;
+}
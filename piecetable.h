@@ -0,0 +1,106 @@
+/**
+  *****************************************************************************
+  *  _____                  ______
+  * /  __ \                 |  _  \
+  * | /  \/_ __ ___  ___ ___| | | |___   ___ ___
+  * | |   | '__/ _ \/ __/ __| | | / _ \ / __/ __|
+  * | \__/\ | | |_| \__ \__ \ |/ / |_| | (__\__ \
+  *  \____/_|  \___/|___/___/___/ \___/ \___|___/
+  *
+  *****************************************************************************
+  *
+  * @file    piecetable.h
+  * @author  Martin Vincent Bloedorn
+  * @version V0.1.0
+  * @date    17-October-2026
+  * @brief   Piece table holding the text of an input file.
+**/
+
+#ifndef PIECETABLE_H
+#define PIECETABLE_H
+
+#include <QString>
+#include <QSharedPointer>
+#include <QIODevice>
+#include <QTextCodec>
+
+/**
+ * @brief Text kept as a sequence of pieces of two kinds of buffers: the original text (as loaded, never
+ * changed) and append-only chunks holding everything inserted since.
+ * Pieces are the nodes of a persistent treap ordered by position, so inserting or removing text costs
+ * O(log n) in the number of pieces, and never copies the text itself. Nodes are immutable and shared:
+ * copying a pieceTable is O(1) and gives a snapshot that can be read from another thread (e.g. to
+ * extract its structure or save it) while the original keeps being edited.
+ */
+class pieceTable
+{
+public:
+    pieceTable();
+    explicit pieceTable(const QString &original);
+
+    int  length() const;
+    bool isEmpty() const { return length() == 0; }
+
+    void insert(int position, const QString &text);
+    void remove(int position, int count);
+    void replace(int position, int count, const QString &text);
+
+    /// \brief Whole text. Free for unedited text (the original string is shared), O(n) otherwise.
+    QString toString() const;
+    QString mid(int position, int count) const;
+
+    /// \brief Whether the text equals \em text , compared piece by piece (nothing is copied).
+    bool equals(const QString &text) const;
+
+    /// \brief Writes the text to \em device as UTF-8, piece by piece and in bounded blocks.
+    bool write(QIODevice * device) const;
+
+    int pieceCount() const;
+
+private:
+    typedef QSharedPointer<QString> CDC_pieceSource;
+
+    typedef struct {
+        CDC_pieceSource source;     /// Original text or an add chunk
+        int start;
+        int length;
+    } CDC_piece;
+
+    struct CDC_pieceNode;
+    typedef QSharedPointer<const CDC_pieceNode> CDC_pieceNodePtr;
+
+    struct CDC_pieceNode {
+        CDC_piece piece;
+        CDC_pieceNodePtr left;
+        CDC_pieceNodePtr right;
+        int length;                 /// Length of the text of the whole subtree
+        int count;                  /// Number of pieces in the whole subtree
+        quint32 priority;           /// Treap priority: never lower than the children's
+    };
+
+    CDC_pieceNodePtr root;
+    CDC_pieceSource original;
+    CDC_pieceSource addChunk;       /// Chunk new text is appended to (see appendText() )
+    quint32 seed;                   /// State of the priority generator
+
+    /// \brief Copies \em text into an add chunk, and returns the piece referring to it.
+    CDC_piece appendText(const QString &text);
+    quint32 nextPriority();
+
+    static int lengthOf(const CDC_pieceNodePtr &node) { return node.isNull() ? 0 : node->length; }
+    static CDC_pieceNodePtr makeNode(const CDC_piece &piece, const CDC_pieceNodePtr &left,
+                                     const CDC_pieceNodePtr &right, quint32 priority);
+    static void split(const CDC_pieceNodePtr &node, int position, CDC_pieceNodePtr &left, CDC_pieceNodePtr &right);
+    static CDC_pieceNodePtr merge(const CDC_pieceNodePtr &left, const CDC_pieceNodePtr &right);
+
+    /// \brief Tree \em node with its last piece made \em count characters longer.
+    static CDC_pieceNodePtr extendLast(const CDC_pieceNodePtr &node, int count);
+    static const CDC_piece * lastPiece(const CDC_pieceNodePtr &node);
+
+    /// \brief Calls \em f (const QChar *, int) for the text in [position, position + count) of \em node ,
+    /// in order and until it returns FALSE.
+    template <typename F>
+    static bool visit(const CDC_pieceNodePtr &node, int position, int count, F f);
+};
+
+#endif // PIECETABLE_H
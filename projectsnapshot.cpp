@@ -0,0 +1,177 @@
+/**
+  *****************************************************************************
+  *  _____                  ______
+  * /  __ \                 |  _  \
+  * | /  \/_ __ ___  ___ ___| | | |___   ___ ___
+  * | |   | '__/ _ \/ __/ __| | | / _ \ / __/ __|
+  * | \__/\ | | |_| \__ \__ \ |/ / |_| | (__\__ \
+  *  \____/_|  \___/|___/___/___/ \___/ \___|___/
+  *
+  *****************************************************************************
+  *
+  * @file    projectsnapshot.cpp
+  * @author  Martin Vincent Bloedorn
+  * @version V0.1.0
+  * @date    17-October-2026
+  * @brief   Binary snapshot of a configured project, to skip parsing on reopen.
+**/
+
+#include "projectsnapshot.h"
+
+// Snapshot header. Bump the version whenever the layout below changes.
+const quint32 snapshotMagic   = 0x43444353; // "CDCS"
+const quint32 snapshotVersion = 1;
+
+static inline bool sameStamp(const CDC_fileStamp &a, const CDC_fileStamp &b) {
+    return a.size == b.size && a.modified == b.modified;
+}
+
+static QDataStream & operator<<(QDataStream &out, const CDC_fileStamp &stamp) {
+    return out << stamp.size << stamp.modified;
+}
+
+static QDataStream & operator>>(QDataStream &in, CDC_fileStamp &stamp) {
+    return in >> stamp.size >> stamp.modified;
+}
+
+/**************************************** CONSTRUCTOR *******************************************/
+projectSnapshot::projectSnapshot() :
+    buildEngine(CDC_buildEngine::none)
+{
+    cdcStamp.size     = -1;
+    cdcStamp.modified = 0;
+}
+
+/**************************************** METHODS ***********************************************/
+bool projectSnapshot::load(const QString &path) {
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly) || file.size() == 0)
+        return false;
+    uchar * data = file.map(0, file.size());
+    if(data == NULL) {
+        file.close();
+        return false;
+    }
+    // Read straight from the mapped file, with no intermediate copy
+    QByteArray raw = QByteArray::fromRawData(reinterpret_cast<const char *>(data), static_cast<int>(file.size()));
+    QDataStream in(raw);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic, version;
+    in >> magic >> version;
+    bool retval = in.status() == QDataStream::Ok && magic == snapshotMagic && version == snapshotVersion;
+    if(retval) {
+        read(in);
+        retval = in.status() == QDataStream::Ok;
+    }
+    file.unmap(data);
+    file.close();
+    if(!retval) {
+        qDebug() << QString(__FUNCTION__) << "Ignoring invalid or outdated snapshot" << path;
+        documents.clear();
+        inputFiles.clear();
+    }
+    return retval;
+}
+
+bool projectSnapshot::save(const QString &path) const {
+    // Written to a temporary file and renamed over the old snapshot: never left half written
+    QSaveFile file(path);
+    if(!file.open(QIODevice::WriteOnly)) {
+        qWarning() << QString(__FUNCTION__) << "Unable to save" << path;
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << snapshotMagic << snapshotVersion;
+    write(out);
+    if(out.status() != QDataStream::Ok) {
+        qWarning() << QString(__FUNCTION__) << "Unable to write" << path;
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool projectSnapshot::isConfigurationCurrent(const QString &path) const {
+    if(path != cdcPath || !sameStamp(cdcStamp, stampOf(path)))
+        return false;
+    for (int i = 0; i < documents.length(); ++i)
+        if(!documents[i].complete || !sameStamp(documents[i].cddStamp, stampOf(documents[i].cddPath)))
+            return false;
+    return true;
+}
+
+bool projectSnapshot::getStructure(const QString &path, CDC_fileSyntax syntax,
+                                   QList<CDC_docStructuralElement> &elements, CDC_fileStamp * stamp) const {
+    QHash<QString, CDC_inputFileSnapshot>::const_iterator it = inputFiles.constFind(path);
+    if(it == inputFiles.constEnd() || it.value().syntax != syntax || !sameStamp(it.value().stamp, stampOf(path)))
+        return false;
+    elements = it.value().elements;
+    if(stamp != NULL) *stamp = it.value().stamp;
+    return true;
+}
+
+CDC_fileStamp projectSnapshot::stampOf(const QString &path) {
+    CDC_fileStamp stamp;
+    QFileInfo info(path);
+    stamp.size     = info.exists() ? info.size() : -1;
+    stamp.modified = info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0;
+    return stamp;
+}
+
+// PRIVATE ------------------------------------------------------------------------
+void projectSnapshot::read(QDataStream &in) {
+    qint32 engine, count;
+    in >> cdcPath >> cdcStamp >> projectTag >> projectName >> engine;
+    buildEngine = static_cast<CDC_buildEngine>(engine);
+
+    documents.clear();
+    in >> count;
+    for (int i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        CDC_documentSnapshot doc;
+        in >> doc.cddPath >> doc.cddStamp >> doc.tag >> doc.name >> doc.complete >> doc.inputFiles;
+        documents.append(doc);
+    }
+
+    inputFiles.clear();
+    in >> count;
+    for (int i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        qint32 syntax, elementCount;
+        CDC_inputFileSnapshot ifs;
+        in >> path >> ifs.stamp >> syntax >> elementCount;
+        ifs.syntax = static_cast<CDC_fileSyntax>(syntax);
+        for (int j = 0; j < elementCount && in.status() == QDataStream::Ok; ++j) {
+            CDC_docStructuralElement se;
+            qint32 line, index, type;
+            in >> se.tag >> se.name >> line >> index >> type;
+            se.line  = line;
+            se.index = index;
+            se.type  = static_cast<CDC_docStructuralElementType>(type);
+            ifs.elements.append(se);
+        }
+        inputFiles.insert(path, ifs);
+    }
+}
+
+void projectSnapshot::write(QDataStream &out) const {
+    out << cdcPath << cdcStamp << projectTag << projectName << static_cast<qint32>(buildEngine);
+
+    out << static_cast<qint32>(documents.length());
+    for (int i = 0; i < documents.length(); ++i) {
+        const CDC_documentSnapshot &doc = documents[i];
+        out << doc.cddPath << doc.cddStamp << doc.tag << doc.name << doc.complete << doc.inputFiles;
+    }
+
+    out << static_cast<qint32>(inputFiles.size());
+    QHash<QString, CDC_inputFileSnapshot>::const_iterator it;
+    for (it = inputFiles.constBegin(); it != inputFiles.constEnd(); ++it) {
+        const QList<CDC_docStructuralElement> &elements = it.value().elements;
+        out << it.key() << it.value().stamp << static_cast<qint32>(it.value().syntax)
+            << static_cast<qint32>(elements.length());
+        for (int j = 0; j < elements.length(); ++j)
+            out << elements[j].tag << elements[j].name << static_cast<qint32>(elements[j].line)
+                << static_cast<qint32>(elements[j].index) << static_cast<qint32>(elements[j].type);
+    }
+}
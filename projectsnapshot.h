@@ -0,0 +1,95 @@
+/**
+  *****************************************************************************
+  *  _____                  ______
+  * /  __ \                 |  _  \
+  * | /  \/_ __ ___  ___ ___| | | |___   ___ ___
+  * | |   | '__/ _ \/ __/ __| | | / _ \ / __/ __|
+  * | \__/\ | | |_| \__ \__ \ |/ / |_| | (__\__ \
+  *  \____/_|  \___/|___/___/___/ \___/ \___|___/
+  *
+  *****************************************************************************
+  *
+  * @file    projectsnapshot.h
+  * @author  Martin Vincent Bloedorn
+  * @version V0.1.0
+  * @date    17-October-2026
+  * @brief   Binary snapshot of a configured project, to skip parsing on reopen.
+**/
+
+#ifndef PROJECTSNAPSHOT_H
+#define PROJECTSNAPSHOT_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDataStream>
+#include <QDebug>
+
+#include "cdcdefs.h"
+
+/**
+ * @brief Configuration and structure of a project, as they were when the snapshot was taken.
+ * Saved in a versioned binary format (\b QDataStream ) next to the project's cdc file. On reopen, the
+ * snapshot is memory-mapped and every file it refers to is validated by its size and modification time:
+ * only files that changed since have to be parsed again.
+ */
+class projectSnapshot
+{
+public:
+    typedef struct {
+        QString cddPath;
+        CDC_fileStamp cddStamp;
+        QString tag;
+        QString name;
+        bool complete;          /// Whether all input files listed in the cdd file were found
+        QStringList inputFiles; /// Canonical paths, in document order
+    } CDC_documentSnapshot;
+
+    typedef struct {
+        CDC_fileStamp stamp;
+        CDC_fileSyntax syntax;  /// Syntax the structure was extracted with
+        QList<CDC_docStructuralElement> elements;
+    } CDC_inputFileSnapshot;
+
+    projectSnapshot();
+
+    /// \brief Reads a snapshot from \em path . Returns FALSE if missing, unreadable or from another version.
+    bool load(const QString &path);
+    /// \brief Writes the snapshot to \em path , replacing the old one only once it is complete.
+    bool save(const QString &path) const;
+
+    /**
+     * @brief Whether the configuration can be taken from the snapshot instead of the cdc/cdd files.
+     * That is, the snapshot was taken from \em cdcPath , neither it nor any cdd file changed since,
+     * and no document was missing input files (a file that shows up later would go unnoticed).
+     */
+    bool isConfigurationCurrent(const QString &cdcPath) const;
+
+    /**
+     * @brief Gets the structure of input file \em path , if it didn't change since the snapshot.
+     * @param stamp If not NULL, receives the stamp of the file the structure was extracted from.
+     * @return FALSE if the file isn't in the snapshot, changed, or was parsed with another syntax.
+     */
+    bool getStructure(const QString &path, CDC_fileSyntax syntax, QList<CDC_docStructuralElement> &elements,
+                      CDC_fileStamp * stamp = NULL) const;
+
+    static CDC_fileStamp stampOf(const QString &path);
+
+    QString cdcPath;
+    CDC_fileStamp cdcStamp;
+    QString projectTag;
+    QString projectName;
+    CDC_buildEngine buildEngine;
+    QList<CDC_documentSnapshot> documents;
+    QHash<QString, CDC_inputFileSnapshot> inputFiles; /// By canonical path
+
+private:
+    void read(QDataStream &in);
+    void write(QDataStream &out) const;
+};
+
+#endif // PROJECTSNAPSHOT_H
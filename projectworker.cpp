@@ -24,35 +24,75 @@ const QString confsecDocuments   = "documents";
 const QString confsecProjectName = "name";
 const QString confsecBuildEngine = "build_engine";
 
+// Build cache manifest, saved next to the project's cdc file
+const QString buildCacheSuffix   = ".buildcache";
+// Project snapshot, saved next to the project's cdc file
+const QString snapshotSuffix     = ".snapshot";
+// Quiet time after the last change notification before external changes are reported
+const int fileChangeDelayMs      = 200;
+
+/// Wrapper around documentWorker::configureDocument() , to use with QtConcurrent::blockingMap .
+static void configureDocumentInPlace(documentWorker *& doc) {
+    doc->configureDocument();
+}
+
 /**************************************** CONSTRUCTOR *******************************************/
 projectWorker::projectWorker(QObject *parent) :
-    QObject(parent)
+    QObject(parent),
+    buildEnginePath(QString("doxygen")),
+    structureUpdatePending(false),
+    watchFiles(false)
 {
-    process   = new QProcess;
+    bw        = new buildWorker(this);
     fp        = new configurationFileParser;
-    structure = new QStandardItemModel();
+    structure = new structureModel(this);
+    structureWatcher = new QFutureWatcher<void>(this);
+
+    connect(structureWatcher, SIGNAL(finished()), this, SLOT(structureJobsFinished()));
+
+    // Tools like git touch many files at once: wait until they are done before reporting anything
+    fileWatcher     = new QFileSystemWatcher(this);
+    fileChangeTimer = new QTimer(this);
+    fileChangeTimer->setSingleShot(true);
+    fileChangeTimer->setInterval(fileChangeDelayMs);
+    connect(fileWatcher, SIGNAL(fileChanged(QString)), this, SLOT(fileChanged(QString)));
+    connect(fileChangeTimer, SIGNAL(timeout()), this, SIGNAL(externalChangesDetected()));
+
+    // Cache bookkeeping has to happen before the signals are forwarded
+    connect(bw, SIGNAL(jobFinished(QString,bool)), this, SLOT(documentBuildFinished(QString,bool)));
+    connect(bw, SIGNAL(finished(bool)), this, SLOT(saveBuildCache()));
+
+    connect(bw, SIGNAL(outputLine(QString,QString,bool)), this, SIGNAL(buildOutput(QString,QString,bool)));
+    connect(bw, SIGNAL(jobFinished(QString,bool)), this, SIGNAL(buildDocumentFinished(QString,bool)));
+    connect(bw, SIGNAL(progress(int,int)), this, SIGNAL(buildProgress(int,int)));
+    connect(bw, SIGNAL(finished(bool)), this, SIGNAL(buildFinished(bool)));
 }
 
 projectWorker::~projectWorker() {
+    structureWatcher->waitForFinished();
     for (int i = 0; i < project.documents.length(); ++i)
         delete project.documents[i];
     delete fp;
-    delete process;
+    delete bw;
 }
 
 /**************************************** METHODS ***********************************************/
 
 bool projectWorker::configureProject(QString prjconffile, CDC_status *retStatus) {
+    // Nothing changed in the cdc/cdd files since the snapshot was taken: skip parsing them
+    projectSnapshot snapshot;
+    bool haveSnapshot = snapshot.load(prjconffile + snapshotSuffix);
+    if(haveSnapshot && snapshot.isConfigurationCurrent(prjconffile)) {
+        qDebug() << QString(__FUNCTION__) << "Configuration restored from snapshot";
+        if(retStatus != NULL) *retStatus = CDC_status::ok;
+        resetProject(prjconffile);
+        restoreProject(snapshot);
+        return finishConfiguration(&snapshot);
+    }
+
     if(fp->parseFile(prjconffile, retStatus)) {
-        QDir dir(prjconffile);
-        basePath = QString(prjconffile);
-        basePath.chop(dir.dirName().length());
         //File parsed, now check for sections
-
-        //Clear any old existing project defs
-        project.documents.clear();
-        project.name.clear();
-        project.tag.clear();
+        resetProject(prjconffile);
 
         QStringList tempList;
 
@@ -80,10 +120,14 @@ bool projectWorker::configureProject(QString prjconffile, CDC_status *retStatus)
                        << confsecBuildEngine << " Your documents should have it!";
             project.buildEngine = CDC_buildEngine::none;
         } else {
-            if(tempList[0].compare(QString("doxygen")))
+            if(tempList[0].compare(QString("doxygen")) == 0)
                 project.buildEngine = CDC_buildEngine::doxygen;
-            else if(tempList[0].compare(QString("custom")))
+            else if(tempList[0].compare(QString("markdown")) == 0)
+                project.buildEngine = CDC_buildEngine::markdown;
+            else if(tempList[0].compare(QString("custom")) == 0)
                 project.buildEngine = CDC_buildEngine::custom;
+            else
+                project.buildEngine = CDC_buildEngine::none;
         }
 
         // Documents -----------------------------------------------
@@ -103,49 +147,206 @@ bool projectWorker::configureProject(QString prjconffile, CDC_status *retStatus)
         }
         // Parse documents that were found. Has to be the last operation, since
         // fp will be cleansed internally!
-        configureAllDocuments();
-
-        // Verify any repeated document tag
-        QStringList taglist;
-        for(int i = 0; i < project.documents.length(); ++i)
-            taglist.append(project.documents[i]->getTag());
-        for(int i = 0; i < project.documents.length(); ++i)
-            if(taglist.lastIndexOf(project.documents[i]->getTag()) != i) {
-                qWarning() << QString(__FUNCTION__) << "Repeated document tag: "
-                           << project.documents[i]->getTag() << " Aborting.";
-                return false;
-            }
+        bool documentsOk = configureAllDocuments();
+        if(!documentsOk) {
+            qWarning() << QString(__FUNCTION__) << "Some documents could not be configured.";
+            if(retStatus != NULL) *retStatus = CDC_status::syntaxError;
+        }
 
-        return true;
+        // Input files that didn't change can still take their structure from the snapshot
+        bool finished = finishConfiguration(haveSnapshot ? &snapshot : NULL);
+        return documentsOk && finished;
     }
     else
         return false;
 }
 
-QStandardItemModel * projectWorker::getProjectStructure() {
-    structure->clear();
-    // Append the strcuture of each document in the project
-    for (int i = 0; i < project.documents.length(); ++i)
-        if(project.documents[i]->getDocumentStructure()->columnCount() > 0)
-            structure->invisibleRootItem()->appendRow(project.documents[i]->getDocumentStructure()->takeColumn(0));
+bool projectWorker::saveSnapshot() {
+    if(confFilePath.isEmpty())
+        return false;
+
+    projectSnapshot snapshot;
+    snapshot.cdcPath     = confFilePath;
+    snapshot.cdcStamp    = projectSnapshot::stampOf(confFilePath);
+    snapshot.projectTag  = project.tag;
+    snapshot.projectName = project.name;
+    snapshot.buildEngine = project.buildEngine;
+    for (int i = 0; i < project.documents.length(); ++i) {
+        documentWorker * doc = project.documents[i];
+        projectSnapshot::CDC_documentSnapshot ds;
+        ds.cddPath    = doc->getConfFilePath();
+        ds.cddStamp   = projectSnapshot::stampOf(ds.cddPath);
+        ds.tag        = doc->getTag();
+        ds.name       = doc->getName();
+        ds.complete   = !doc->hasMissingInputFiles();
+        ds.inputFiles = doc->getInputFilesList();
+        snapshot.documents.append(ds);
+
+        // Only structures that match the files on disk are worth keeping
+        for (int j = 0; j < ds.inputFiles.length(); ++j) {
+            // The stamp is the one the file had when it was read, not now: a file that changed since
+            // is then simply parsed again on reopen
+            projectSnapshot::CDC_inputFileSnapshot ifs;
+            if(snapshot.inputFiles.contains(ds.inputFiles[j]) || !doc->getCachedStructure(j, ifs.elements, ifs.stamp))
+                continue;
+            ifs.syntax = doc->getInputFileSyntax(j);
+            snapshot.inputFiles.insert(ds.inputFiles[j], ifs);
+        }
+    }
+    return snapshot.save(confFilePath + snapshotSuffix);
+}
+
+structureModel * projectWorker::getProjectStructure() {
+    // Rows map 1:1 to documents. If that doesn't hold anymore (e.g. new project), rebuild everything.
+    bool rebuild = structure->rowCount() != project.documents.length();
+    bool changed = rebuild;
+    if(rebuild)
+        structure->clear();
+
+    // Append the strcuture of each document in the project, or replace only the ones that changed
+    for (int i = 0; i < project.documents.length(); ++i) {
+        if(rebuild)
+            structure->appendDocument(project.documents[i]->getTag(), project.documents[i]->getName());
+        else if(!project.documents[i]->isStructureOutdated())
+            continue;
+        changed = true;
+        structure->setDocumentStructure(i, project.documents[i]->getDocumentStructure());
+    }
+    if(changed)
+        updateStructureIndex();
+    if(rebuild)
+        saveSnapshot(); // the whole project was just parsed
     return structure;
 }
 
+void projectWorker::requestStructureUpdate() {
+    if(structureWatcher->isRunning()) {
+        structureUpdatePending = true;
+        return;
+    }
+    structureUpdatePending = false;
+    structureJobs.clear();
+    structureJobDocuments.clear();
+    for (int i = 0; i < project.documents.length(); ++i) {
+        int first = structureJobs.length();
+        project.documents[i]->getStructureJobs(structureJobs);
+        for (int j = first; j < structureJobs.length(); ++j)
+            structureJobDocuments.append(project.documents[i]);
+    }
+    if(structureJobs.isEmpty()) {
+        emit structureUpdated();
+        return;
+    }
+    // structureJobs is left untouched until the watcher reports the jobs are done
+    structureWatcher->setFuture(QtConcurrent::map(structureJobs, documentWorker::runStructureJob));
+}
+
+int projectWorker::extractProjectStructure() {
+    int count = 0;
+    for (int i = 0; i < project.documents.length(); ++i) {
+        project.documents[i]->updateStructureCache();
+        count += project.documents[i]->getStructuralElementCount();
+    }
+    updateStructureIndex();
+    saveSnapshot();
+    return count;
+}
+
+bool projectWorker::getStructuralElementLocation(QString elemtag, CDC_docStructuralElementLocation &location,
+                                                 QString doctag) {
+    if(!doctag.isEmpty()) {
+        documentWorker * doc = documentsByTag.value(doctag, NULL);
+        return doc != NULL && doc->getStructuralElementLocation(elemtag, location);
+    }
+    QHash<QString, CDC_docStructuralElementLocation>::const_iterator it = structureIndex.constFind(elemtag);
+    if(it == structureIndex.constEnd())
+        return false;
+    location = it.value();
+    return true;
+}
+
 bool projectWorker::build(QString prjconffile, CDC_status *retStatus) {
-    QString cmd("/usr/local/bin/doxygen");
-    QStringList args;
+    if(retStatus != NULL) *retStatus = CDC_status::ok;
+    if(!prjconffile.isEmpty() && !configureProject(prjconffile, retStatus))
+        return false;
 
-    args << "-g";
+    bool done = false;
+    bool ok   = false;
+    QEventLoop loop;
+    QMetaObject::Connection conn = connect(bw, &buildWorker::finished, &loop, [&](bool result) {
+        done = true;
+        ok   = result;
+        loop.quit();
+    });
+    if(!startBuild()) {
+        disconnect(conn);
+        if(retStatus != NULL) *retStatus = CDC_status::paramError;
+        return false;
+    }
+    if(!done) // finished() may have been emitted already, if nothing had to be built
+        loop.exec();
+    disconnect(conn);
 
-    process->start(cmd, args, QIODevice::ReadOnly);
-    process->waitForFinished();
+    if(!ok && retStatus != NULL) *retStatus = CDC_status::ioError;
+    return ok;
+}
 
-    QString StdOut   = process->readAllStandardOutput();  //Reads standard output
-    QString StdError = process->readAllStandardError();   //Reads standard error
+bool projectWorker::startBuild() {
+    if(bw->isRunning()) {
+        qWarning() << QString(__FUNCTION__) << "A build is already running";
+        return false;
+    }
 
-    std::cout << StdOut.toStdString() << std::endl;
+    loadBuildCache();
+    pendingBuildKeys.clear();
 
-    return true;
+    for (int i = 0; i < project.documents.length(); ++i) {
+        documentWorker * doc = project.documents[i];
+        if(doc->getBuildEngine() != CDC_buildEngine::doxygen) {
+            qWarning() << QString(__FUNCTION__) << "No supported build engine for" << doc->getTag() << "- skipped";
+            continue;
+        }
+
+        QString outputPath = getDocumentOutputPath(doc->getTag());
+        QByteArray config  = getDoxygenConfiguration(doc);
+        QByteArray key     = getBuildKey(doc, config);
+
+        // Nothing changed since the last successful build, and its output is still there
+        if(buildCache.value(doc->getTag()) == key && QDir(outputPath).exists()) {
+            qDebug() << QString(__FUNCTION__) << doc->getTag() << "is up to date";
+            continue;
+        }
+
+        if(!QDir().mkpath(outputPath)) {
+            qWarning() << QString(__FUNCTION__) << "Unable to create" << outputPath;
+            continue;
+        }
+
+        // Doxygen reads its configuration from stdin when given '-'
+        pendingBuildKeys.insert(doc->getTag(), key);
+        bw->addJob(doc->getTag(), buildEnginePath, QStringList() << "-", outputPath, config);
+    }
+    return bw->start();
+}
+
+void projectWorker::cancelBuild() {
+    bw->cancel();
+}
+
+bool projectWorker::isBuilding() {
+    return bw->isRunning();
+}
+
+int projectWorker::getMaxBuildJobs() {
+    return bw->getMaxJobs();
+}
+
+void projectWorker::setMaxBuildJobs(int value) {
+    bw->setMaxJobs(value);
+}
+
+QString projectWorker::getDocumentOutputPath(QString doctag) {
+    return basePath + "build/" + doctag + "/";
 }
 
 QString projectWorker::getDocumentInputFileContents(QString doctag, int ifIndex, CDC_status *retStatus) {
@@ -153,17 +354,13 @@ QString projectWorker::getDocumentInputFileContents(QString doctag, int ifIndex,
 }
 
 void projectWorker::setDocumentInputFileContents(QString doctag, int ifIndex, QString content, CDC_status *retStatus) {
-    //check for multiple references for the same input file
-    QStringList iflist = getDocumentbyTag(doctag)->getInputFilesList();
-    if(iflist.length() > ifIndex && iflist.length() > 0) {
-        QString ifname = iflist[ifIndex];
-        int index;
-        for (int i = 0; i < project.documents.length(); ++i) {
-            index = project.documents[i]->getInputFilesList().lastIndexOf(ifname);
-            if(index != -1)
-                project.documents[i]->setInputFileContents(index, content, retStatus);
-        }
-    }
+    // Buffers are shared, so every document that includes this file sees the new contents
+    getDocumentbyTag(doctag)->setInputFileContents(ifIndex, content, retStatus);
+}
+
+void projectWorker::editDocumentInputFileContents(QString doctag, int ifIndex, int position, int removed,
+                                                 const QString &added, CDC_status *retStatus) {
+    getDocumentbyTag(doctag)->editInputFileContents(ifIndex, position, removed, added, retStatus);
 }
 
 void projectWorker::setDocumentInputFileSyntax(QString doctag, int ifIndex, CDC_fileSyntax syntax) {
@@ -174,6 +371,117 @@ CDC_fileSyntax projectWorker::getDocumentInputFileSyntax(QString doctag, int ifI
     return getDocumentbyTag(doctag)->getInputFileSyntax(ifIndex);
 }
 
+void projectWorker::setWatchFiles(bool value) {
+    watchFiles = value;
+    updateWatchedFiles();
+}
+
+bool projectWorker::applyExternalChanges(QStringList * reloaded, QStringList * conflicting) {
+    bool configurationChanged = false;
+    bool structureChanged     = false;
+    QSet<QString> paths = changedFiles;
+    changedFiles.clear();
+
+    QSet<QString>::const_iterator it;
+    for (it = paths.constBegin(); it != paths.constEnd(); ++it) {
+        // Files replaced by renaming (as most editors and git do) are dropped by the watcher
+        if(QFile::exists(*it) && !fileWatcher->files().contains(*it))
+            fileWatcher->addPath(*it);
+
+        CDC_inputFileHandle buffer = inputFileRegistry.value(*it);
+        if(buffer.isNull()) { // Not an input file: cdc or cdd
+            configurationChanged = true;
+            continue;
+        }
+        if(buffer->modified) {
+            qWarning() << QString(__FUNCTION__) << *it << "changed on disk, but has unsaved modifications. Keeping them.";
+            if(conflicting != NULL) conflicting->append(*it);
+            continue;
+        }
+        if(buffer->contents.isEmpty()) {
+            // Never loaded: only its structure has to be extracted again, straight from disk
+            buffer->revision++;
+            structureChanged = true;
+            if(reloaded != NULL) reloaded->append(*it);
+            continue;
+        }
+        QFile file(*it);
+        QString contents;
+        CDC_fileStamp stamp = projectSnapshot::stampOf(*it);
+        if(!documentWorker::readFileContents(&file, contents)) {
+            qWarning() << QString(__FUNCTION__) << "Unable to reload" << *it;
+            continue;
+        }
+        buffer->stamp = stamp;
+        if(buffer->contents.equals(contents)) // e.g. our own save
+            continue;
+        buffer->contents = pieceTable(contents);
+        buffer->revision++;
+        structureChanged = true;
+        if(reloaded != NULL) reloaded->append(*it);
+    }
+    if(structureChanged)
+        requestStructureUpdate();
+    return configurationChanged;
+}
+
+int projectWorker::saveAllInputFiles(CDC_status * retStatus) {
+    QList<CDC_saveJob> jobs;
+    QHash<QString, CDC_inputFileHandle>::const_iterator it;
+    for (it = inputFileRegistry.constBegin(); it != inputFileRegistry.constEnd(); ++it) {
+        if(!it.value()->modified)
+            continue;
+        CDC_saveJob job;
+        job.filePath = it.key();
+        job.contents = it.value()->contents;
+        job.revision = it.value()->revision;
+        job.ok       = false;
+        jobs.append(job);
+    }
+    if(jobs.isEmpty())
+        return 0;
+
+    QtConcurrent::blockingMap(jobs, [](CDC_saveJob &job) {
+        job.ok = documentWorker::writeFileContents(job.filePath, job.contents);
+    });
+
+    // Renames are only durable once their directories are synced: once per directory
+    QSet<QString> directories;
+    int saved = 0;
+    for (int i = 0; i < jobs.length(); ++i) {
+        if(!jobs[i].ok) {
+            qWarning() << QString(__FUNCTION__) << "Unable to save to file" << jobs[i].filePath;
+            if(retStatus != NULL) *retStatus = CDC_status::ioError;
+            continue;
+        }
+        directories.insert(QFileInfo(jobs[i].filePath).absolutePath());
+        CDC_inputFileHandle buffer = inputFileRegistry.value(jobs[i].filePath);
+        if(buffer->revision == jobs[i].revision) { // otherwise, it changed again while being saved
+            buffer->modified = false;
+            buffer->stamp    = projectSnapshot::stampOf(jobs[i].filePath);
+        }
+        saved++;
+    }
+    QSet<QString>::const_iterator dir;
+    for (dir = directories.constBegin(); dir != directories.constEnd(); ++dir)
+        if(!documentWorker::syncDirectory(*dir))
+            qWarning() << QString(__FUNCTION__) << "Unable to sync directory" << *dir;
+    return saved;
+}
+
+int projectWorker::getInputFileRevision(QString path) {
+    CDC_inputFileHandle buffer = inputFileRegistry.value(path);
+    return buffer.isNull() ? -1 : buffer->revision;
+}
+
+bool projectWorker::hasUnsavedChanges() {
+    QHash<QString, CDC_inputFileHandle>::const_iterator it;
+    for (it = inputFileRegistry.constBegin(); it != inputFileRegistry.constEnd(); ++it)
+        if(it.value()->modified)
+            return true;
+    return false;
+}
+
 QStringList projectWorker::getDocumentInputFilesList(QString doctag) {
     return getDocumentbyTag(doctag)->getInputFilesList();
 }
@@ -191,17 +499,249 @@ QStringList projectWorker::getDocumentTagList() {
 }
 
 
+// PRIVATE SLOTS ------------------------------------------------------------------
+void projectWorker::documentBuildFinished(QString doctag, bool ok) {
+    if(ok && pendingBuildKeys.contains(doctag))
+        buildCache.insert(doctag, pendingBuildKeys.value(doctag));
+    else
+        buildCache.remove(doctag); // output can't be trusted anymore
+    pendingBuildKeys.remove(doctag);
+}
+
+void projectWorker::saveBuildCache() {
+    if(confFilePath.isEmpty())
+        return;
+
+    CDC_confList list;
+    QHash<QString, QByteArray>::const_iterator it;
+    for (it = buildCache.constBegin(); it != buildCache.constEnd(); ++it) {
+        CDC_confSection sec;
+        // Percent-encoded: tags may hold spaces, ':' or '#', which the cdc syntax would read as its own
+        sec.header = QString::fromLatin1(QUrl::toPercentEncoding(it.key()));
+        sec.contentsList.append(QString::fromLatin1(it.value()));
+        list.append(sec);
+    }
+    configurationFileParser cacheParser;
+    if(!cacheParser.saveToConfigurationFile(confFilePath + buildCacheSuffix, list))
+        qWarning() << QString(__FUNCTION__) << "Unable to save" << confFilePath + buildCacheSuffix;
+}
+
+void projectWorker::structureJobsFinished() {
+    // Hand each document its own jobs back
+    bool upToDate = true;
+    int first = 0;
+    while(first < structureJobs.length()) {
+        int last = first;
+        while(last + 1 < structureJobs.length() && structureJobDocuments[last + 1] == structureJobDocuments[first])
+            last++;
+        if(!structureJobDocuments[first]->applyStructureJobs(structureJobs.mid(first, last - first + 1)))
+            upToDate = false;
+        first = last + 1;
+    }
+    structureJobs.clear();
+    structureJobDocuments.clear();
+
+    if(structureUpdatePending || !upToDate)
+        requestStructureUpdate(); // only the latest contents are worth showing
+    else {
+        updateStructureIndex();
+        emit structureUpdated();
+    }
+}
+
+void projectWorker::fileChanged(QString path) {
+    changedFiles.insert(path);
+    fileChangeTimer->start();
+}
+
 // PRIVATE ------------------------------------------------------------------------
+void projectWorker::loadBuildCache() {
+    buildCache.clear();
+    if(confFilePath.isEmpty() || !QFile::exists(confFilePath + buildCacheSuffix))
+        return;
+
+    // The manifest uses the cdc syntax: one section per (percent-encoded) document tag, holding its build key
+    configurationFileParser cacheParser;
+    if(!cacheParser.parseFile(confFilePath + buildCacheSuffix))
+        return;
+    const QStringList &tags = cacheParser.getFileSections();
+    for (int i = 0; i < tags.length(); ++i) {
+        const QStringList &contents = cacheParser.getSectionContents(tags[i]);
+        if(!contents.isEmpty())
+            buildCache.insert(QUrl::fromPercentEncoding(tags[i].toLatin1()), contents[0].trimmed().toLatin1());
+    }
+}
+
+QByteArray projectWorker::getDoxygenConfiguration(documentWorker * doc) {
+    QStringList iflist = doc->getInputFilesList();
+    QString config;
+    config += "PROJECT_NAME = \"" + doc->getName() + "\"\n";
+    config += "OUTPUT_DIRECTORY = \"" + getDocumentOutputPath(doc->getTag()) + "\"\n";
+    config += "INPUT =";
+    for (int j = 0; j < iflist.length(); ++j)
+        config += " \"" + iflist[j] + "\"";
+    config += "\n";
+    config += "EXTENSION_MAPPING = cdp=md\n"; // input files are plain text with doxygen commands
+    config += "GENERATE_LATEX = NO\n";
+    return config.toLocal8Bit();
+}
+
+QByteArray projectWorker::getBuildKey(documentWorker * doc, const QByteArray &config) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    // Build engine settings
+    hash.addData(QByteArray::number(static_cast<int>(doc->getBuildEngine())));
+    hash.addData(buildEnginePath.toLocal8Bit());
+    hash.addData(config);
+
+    // Document's cdd and input files, as the build engine will read them from disk
+    QStringList files = doc->getInputFilesList();
+    files.prepend(doc->getConfFilePath());
+    for (int i = 0; i < files.length(); ++i) {
+        QFile file(files[i]);
+        hash.addData(files[i].toLocal8Bit());
+        if(file.open(QIODevice::ReadOnly)) {
+            hash.addData(&file);
+            file.close();
+        }
+    }
+    return hash.result().toHex();
+}
+
+void projectWorker::resetProject(QString prjconffile) {
+    QDir dir(prjconffile);
+    confFilePath = prjconffile;
+    basePath = QString(prjconffile);
+    basePath.chop(dir.dirName().length());
+
+    // The background structure update refers to the old documents
+    structureWatcher->waitForFinished();
+    structureJobs.clear();
+    structureJobDocuments.clear();
+    structureUpdatePending = false;
+
+    changedFiles.clear();
+    fileChangeTimer->stop();
+
+    //Clear any old existing project defs (buffers shared through the registry go with their documents)
+    inputFileRegistry.clear();
+    qDeleteAll(project.documents);
+    project.documents.clear();
+    project.name.clear();
+    project.tag.clear();
+    structure->clear();
+    structureIndex.clear();
+    documentsByTag.clear();
+}
+
+void projectWorker::restoreProject(const projectSnapshot &snapshot) {
+    project.tag         = snapshot.projectTag;
+    project.name        = snapshot.projectName;
+    project.buildEngine = snapshot.buildEngine;
+    for (int i = 0; i < snapshot.documents.length(); ++i) {
+        const projectSnapshot::CDC_documentSnapshot &ds = snapshot.documents[i];
+        documentWorker * pd = new documentWorker();
+        pd->setBuildEngine(project.buildEngine);
+        pd->restoreConfiguration(ds.cddPath, ds.tag, ds.name, ds.inputFiles);
+        project.documents.append(pd);
+    }
+}
+
+bool projectWorker::finishConfiguration(const projectSnapshot * snapshot) {
+    shareInputFileBuffers();
+    updateWatchedFiles();
+
+    // Verify any repeated document tag
+    QStringList taglist;
+    for(int i = 0; i < project.documents.length(); ++i)
+        taglist.append(project.documents[i]->getTag());
+    for(int i = 0; i < project.documents.length(); ++i)
+        if(taglist.lastIndexOf(project.documents[i]->getTag()) != i) {
+            qWarning() << QString(__FUNCTION__) << "Repeated document tag: "
+                       << project.documents[i]->getTag() << " Aborting.";
+            return false;
+        }
+    for(int i = 0; i < project.documents.length(); ++i)
+        documentsByTag.insert(project.documents[i]->getTag(), project.documents[i]);
+
+    if(snapshot == NULL)
+        return true;
+    // Structure of the input files that didn't change since the snapshot
+    for (int i = 0; i < project.documents.length(); ++i) {
+        documentWorker * doc = project.documents[i];
+        QStringList iflist = doc->getInputFilesList();
+        QHash<int, QList<CDC_docStructuralElement> > structures;
+        QHash<int, CDC_fileStamp> stamps;
+        QList<CDC_docStructuralElement> elements;
+        CDC_fileStamp stamp;
+        for (int j = 0; j < iflist.length(); ++j)
+            if(snapshot->getStructure(iflist[j], doc->getInputFileSyntax(j), elements, &stamp)) {
+                structures.insert(j, elements);
+                stamps.insert(j, stamp);
+            }
+        doc->restoreStructureCache(structures, stamps);
+    }
+    return true;
+}
+
 bool projectWorker::configureAllDocuments() {
     bool retval = true;
+    // Each document owns its parser, so they can all be configured at once. The list itself is
+    // never reordered, which keeps project.documents in the same order as the cdc file.
+    QtConcurrent::blockingMap(project.documents, configureDocumentInPlace);
     for(int i = 0; i < project.documents.length(); ++i)
-        if(!project.documents[i]->configureDocument())
+        if(!project.documents[i]->isConfigured())
             retval = false;
     return retval;
 }
 
-documentWorker* projectWorker::getDocumentbyTag(QString tag) {
+void projectWorker::shareInputFileBuffers() {
+    inputFileRegistry.clear();
+    for (int i = 0; i < project.documents.length(); ++i) {
+        QStringList iflist = project.documents[i]->getInputFilesList(); // already canonical paths
+        for (int j = 0; j < iflist.length(); ++j) {
+            if(inputFileRegistry.contains(iflist[j]))
+                project.documents[i]->setInputFileBuffer(j, inputFileRegistry.value(iflist[j]));
+            else
+                inputFileRegistry.insert(iflist[j], project.documents[i]->getInputFileBuffer(j));
+        }
+    }
+}
+
+void projectWorker::updateWatchedFiles() {
+    if(!fileWatcher->files().isEmpty())
+        fileWatcher->removePaths(fileWatcher->files());
+    if(!watchFiles || confFilePath.isEmpty())
+        return;
+
+    QStringList paths(confFilePath);
     for (int i = 0; i < project.documents.length(); ++i)
+        paths.append(project.documents[i]->getConfFilePath());
+    paths.append(inputFileRegistry.keys());
+    fileWatcher->addPaths(paths);
+}
+
+void projectWorker::updateStructureIndex() {
+    structureIndex.clear();
+    for (int i = 0; i < project.documents.length(); ++i) {
+        const QHash<QString, CDC_docStructuralElementLocation> &docIndex = project.documents[i]->getStructureIndex();
+        QHash<QString, CDC_docStructuralElementLocation>::const_iterator it;
+        for (it = docIndex.constBegin(); it != docIndex.constEnd(); ++it) {
+            if(structureIndex.contains(it.key())) {
+                qWarning() << QString(__FUNCTION__) << "Structural tag" << it.key() << "is used by both"
+                           << structureIndex.value(it.key()).doc << "and" << it.value().doc;
+                continue;
+            }
+            structureIndex.insert(it.key(), it.value());
+        }
+    }
+}
+
+documentWorker* projectWorker::getDocumentbyTag(QString tag) {
+    documentWorker * doc = documentsByTag.value(tag, NULL);
+    if(doc != NULL)
+        return doc;
+    for (int i = 0; i < project.documents.length(); ++i) // tags may have changed after configuration
         if(project.documents[i]->getTag().compare(tag) == 0)
            return project.documents[i];
 
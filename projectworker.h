@@ -28,11 +28,21 @@
 #include <QDebug>
 #include <QProcess>
 #include <QDir>
-#include <QStandardItemModel>
+#include <QEventLoop>
+#include <QCryptographicHash>
+#include <QHash>
+#include <QtConcurrent>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QSet>
+#include <QUrl>
 
 #include "cdcdefs.h"
 #include "configurationfileparser.h"
 #include "documentworker.h"
+#include "buildworker.h"
+#include "structuremodel.h"
+#include "projectsnapshot.h"
 
 class projectWorker : public QObject
 {
@@ -43,16 +53,56 @@ public:
 
     /**
      * @brief Runs configurationFileParser on prjconffile and builds internal project model.
+     * If a snapshot of the project (see saveSnapshot() ) is found and none of the cdc/cdd files changed
+     * since it was taken, the configuration is restored from it instead. Either way, input files that
+     * didn't change since take their structure from the snapshot, and are not parsed again.
      *
      * @param prjconffile \b QString containing the full path to the configuration file.
      * @param retStatus CDC_status of the operation.
-     * @return Whether parse went ok (CDC_status::ok).
+     * @return Whether parse went ok (CDC_status::ok). FALSE as well if any document failed to configure
+     * (e.g. missing or broken cdd file); the other documents are still loaded.
      */
     bool configureProject(QString prjconffile, CDC_status * retStatus = NULL);
     bool configureProject(QDir pcf, CDC_status * rSt = NULL) { return configureProject(pcf.absolutePath(), rSt); }
 
+    /**
+     * @brief Saves a snapshot of the configuration and structure of the project next to the cdc file.
+     * Done after the whole project structure is extracted (see getProjectStructure() and
+     * extractProjectStructure() ). Input files with unsaved modifications are left out.
+     * @return Whether the snapshot was saved.
+     */
+    bool saveSnapshot();
+
+    /**
+     * @brief Builds all documents of the project and waits until they are done.
+     * Runs startBuild() inside a local event loop, for front-ends that can block (e.g. the command line).
+     * @param prjconffile If not empty, the project is (re)configured from this file first.
+     * @param retStatus CDC_status of the operation.
+     * @return Whether all documents were built.
+     */
     bool build(QString prjconffile = QString::QString(""), CDC_status * retStatus = NULL);
 
+    /**
+     * @brief Starts building all documents of the project, without blocking.
+     * One job is run per document (at most getMaxBuildJobs() at once), and its output is streamed
+     * line by line through buildOutput() . buildFinished() is emitted when all jobs are done.
+     * Documents whose build key (see getBuildKey() ) matches the one of their last successful build
+     * are skipped, and their previous output is kept. Keys are stored in a manifest next to the cdc file.
+     * @return FALSE if a build is already running.
+     */
+    bool startBuild();
+    void cancelBuild();
+    bool isBuilding();
+
+    int  getMaxBuildJobs();
+    void setMaxBuildJobs(int value);
+
+    QString getBuildEnginePath()              { return buildEnginePath;  }
+    void setBuildEnginePath(QString value)    { buildEnginePath = value; }
+
+    /// \brief Directory where the output of document \em doctag is generated.
+    QString getDocumentOutputPath(QString doctag);
+
     /**
      * @brief Returns the contents of a certain input file from a document.
      * @param doctag
@@ -64,8 +114,8 @@ public:
 
     /**
      * @brief Changes the contents of the input file from a document.
-     * Also checks if this input file is referenced by more than one document, and updates all
-     * references.
+     * Documents that reference the same input file share its buffer (see shareInputFileBuffers() ),
+     * so all of them are updated at once.
      * Check also documentWorker::getInputFileContents() .
      * @param doctag Tag of the desired document.
      * @param ifIndex Index of the desired input file in that particular document.
@@ -74,10 +124,86 @@ public:
      */
     void    setDocumentInputFileContents(QString doctag, int ifIndex, QString content, CDC_status *retStatus = NULL);
 
+    /// \brief Applies one editor change to an input file of a document. See documentWorker::editInputFileContents() .
+    void    editDocumentInputFileContents(QString doctag, int ifIndex, int position, int removed, const QString &added,
+                                          CDC_status *retStatus = NULL);
+
     void    setDocumentInputFileSyntax(QString doctag, int ifIndex, CDC_fileSyntax syntax);
     CDC_fileSyntax getDocumentInputFileSyntax(QString doctag, int ifIndex);
 
-    QStandardItemModel * getProjectStructure();
+    /**
+     * @brief Returns the structure of all documents in the project, one row per document.
+     * The model is kept between calls: only the rows of documents whose structure is outdated
+     * (see documentWorker::isStructureOutdated() ) are rebuilt in place, so views get row
+     * insertions/removals under those documents instead of a reset.
+     * @return The project's structureModel , owned by the projectWorker.
+     */
+    structureModel * getProjectStructure();
+
+    /**
+     * @brief Starts bringing the cached structure of every document up to date on the thread pool.
+     * Outdated input files are parsed against a snapshot of their contents, so editing can go on
+     * meanwhile. structureUpdated() is emitted once all caches are up to date, and getProjectStructure()
+     * is then cheap to call. Requests made while a parse is running are coalesced into a single new
+     * one, started when the running one finishes; results that got stale in the meantime are dropped.
+     */
+    void requestStructureUpdate();
+
+    /**
+     * @brief Brings the cached structure of every document up to date, without building any model.
+     * See documentWorker::updateStructureCache() .
+     * @return Total number of structural elements found in the project.
+     */
+    int extractProjectStructure();
+
+    /**
+     * @brief Finds where the structural element \em elemtag is, in O(1).
+     * @param elemtag Tag of the desired structural element.
+     * @param location Receives where the element is, if found.
+     * @param doctag If given, only this document is searched. Otherwise, the project-wide index is used
+     * (up to date after getProjectStructure() or extractProjectStructure() ).
+     * @return Whether the element was found.
+     */
+    bool getStructuralElementLocation(QString elemtag, CDC_docStructuralElementLocation &location,
+                                      QString doctag = QString::QString(""));
+
+    /**
+     * @brief Enables watching the cdc, cdd and input files of the project for changes made outside CrossDocs.
+     * Bursts of change notifications are batched, and externalChangesDetected() is emitted once they settle.
+     */
+    void setWatchFiles(bool value);
+    bool getWatchFiles() { return watchFiles; }
+
+    /**
+     * @brief Applies the changes reported by externalChangesDetected() .
+     * Input files without unsaved modifications are reloaded (only if their contents differ from the
+     * buffer) and a background structure update is requested for them. Files with unsaved modifications
+     * are never touched: they are reported as conflicting, and saving them overwrites the external changes.
+     * Edits reach the buffers as they are made (see editDocumentInputFileContents() ), so the
+     * modification flags checked here are always current.
+     * @param reloaded Receives the canonical paths of the input files whose contents changed (including
+     * those never loaded, whose views read them from disk).
+     * @param conflicting Receives the canonical paths of the changed input files with unsaved modifications.
+     * @return Whether the cdc file or any cdd file changed (the project should then be configured again).
+     */
+    bool applyExternalChanges(QStringList * reloaded = NULL, QStringList * conflicting = NULL);
+
+    /**
+     * @brief Saves every input file with unsaved modifications, across all documents, in one pass.
+     * Each file is written once (buffers are shared among documents) and atomically (see
+     * documentWorker::writeFileContents() ): files are written in parallel on the thread pool, and
+     * then each directory they are in is synced once. A crash midway leaves every file either with
+     * its old or its new contents, never truncated.
+     * @param retStatus CDC_status::ioError if any file could not be written (those stay modified).
+     * @return Number of files saved.
+     */
+    int saveAllInputFiles(CDC_status * retStatus = NULL);
+
+    /// \brief Revision of the buffer of input file \em path (canonical), -1 if not in the project.
+    int  getInputFileRevision(QString path);
+
+    /// \brief Whether any input file of the project has unsaved modifications.
+    bool hasUnsavedChanges();
 
     QStringList getDocumentInputFilesList(QString doctag);
     QString     getDocumentName(QString doctag);
@@ -88,9 +214,24 @@ public:
 
 private:
     // Attribues
-    QProcess * process;
+    buildWorker * bw;
+    QString buildEnginePath;
+    QString confFilePath;
     QString basePath;
-    QStandardItemModel * structure;
+    QHash<QString, QByteArray> buildCache;       /// Build key of the last successful build of each doc
+    QHash<QString, QByteArray> pendingBuildKeys; /// Build key of each doc being built right now
+    QHash<QString, CDC_inputFileHandle> inputFileRegistry; /// Input file buffers, by canonical path
+    QHash<QString, documentWorker *> documentsByTag;
+    QHash<QString, CDC_docStructuralElementLocation> structureIndex; /// Project-wide structural tag index
+    structureModel * structure;
+    QFutureWatcher<void> * structureWatcher;
+    QList<CDC_structureJob> structureJobs;          /// Jobs of the background structure update
+    QList<documentWorker *> structureJobDocuments;  /// Document each of structureJobs belongs to
+    bool structureUpdatePending;                    /// A new update was requested while one was running
+    QFileSystemWatcher * fileWatcher;
+    QTimer * fileChangeTimer;                       /// Batches bursts of change notifications
+    QSet<QString> changedFiles;                     /// Files reported by fileWatcher, not applied yet
+    bool watchFiles;
 
     configurationFileParser * fp;
     documentWorker * docw;
@@ -107,12 +248,26 @@ private:
 
     /**
      * @brief Configures all documents already in the project strucutre.
+     * Documents are configured concurrently on QThreadPool::globalInstance() , each with its own parser.
      * If one (or more) document fails to parse, the function will carry on parsing all the
      * other docs, but will return false nontheless.
      * @return Whether parse went ok. Return false if at least one document failed to parse.
      */
     bool configureAllDocuments();
 
+    /// \brief Drops the current project (waiting for background work on it) before configuring \em prjconffile .
+    void resetProject(QString prjconffile);
+
+    /// \brief Creates the project's documents from \em snapshot , without parsing any cdc/cdd file.
+    void restoreProject(const projectSnapshot &snapshot);
+
+    /**
+     * @brief Last steps of configureProject() : shares input file buffers, checks document tags and
+     * seeds the structure caches from \em snapshot (if not NULL).
+     * @return FALSE if document tags are repeated.
+     */
+    bool finishConfiguration(const projectSnapshot * snapshot);
+
     /**
      * @brief Returns the pointer to the project's document with the specified tag.
      * Internal function that is used as general document getter for all other indirect
@@ -122,10 +277,50 @@ private:
      */
     documentWorker* getDocumentbyTag(QString tag);
 
+    /**
+     * @brief Makes all documents that include the same input file (same canonical path) share one buffer.
+     * Done serially after configureAllDocuments() , so documents can still be configured concurrently.
+     */
+    void shareInputFileBuffers();
+
+    /// \brief Makes fileWatcher watch the cdc, cdd and input files of the current project (if enabled).
+    void updateWatchedFiles();
+
+    /**
+     * @brief Merges the structural tag index of every document into the project-wide one.
+     * Tags used by more than one document are reported; the first document keeps the tag.
+     */
+    void updateStructureIndex();
+
+    /// \brief Reads the build cache manifest of the current project into buildCache .
+    void loadBuildCache();
+
+    /// \brief Doxygen configuration used to build \em doc (fed through stdin).
+    QByteArray getDoxygenConfiguration(documentWorker * doc);
+
+    /**
+     * @brief Hash of everything that goes into building \em doc: its cdd file, the contents of its
+     * input files (as on disk) and the build engine settings, \em config included.
+     * @return Hex-encoded SHA-1.
+     */
+    QByteArray getBuildKey(documentWorker * doc, const QByteArray &config);
+
 signals:
+    void buildOutput(QString doctag, QString line, bool isError);
+    void buildDocumentFinished(QString doctag, bool ok);
+    void buildProgress(int done, int total);
+    void buildFinished(bool ok);
+    void structureUpdated();
+    void externalChangesDetected();
 
 public slots:
 
+private slots:
+    void documentBuildFinished(QString doctag, bool ok);
+    void saveBuildCache();
+    void structureJobsFinished();
+    void fileChanged(QString path);
+
 };
 
 #endif // PROJECTWORKER_H
@@ -0,0 +1,275 @@
+/**
+  *****************************************************************************
+  *  _____                  ______
+  * /  __ \                 |  _  \
+  * | /  \/_ __ ___  ___ ___| | | |___   ___ ___
+  * | |   | '__/ _ \/ __/ __| | | / _ \ / __/ __|
+  * | \__/\ | | |_| \__ \__ \ |/ / |_| | (__\__ \
+  *  \____/_|  \___/|___/___/___/ \___/ \___|___/
+  *
+  *****************************************************************************
+  *
+  * @file    structuremodel.cpp
+  * @author  Martin Vincent Bloedorn
+  * @version V0.1.0
+  * @date    17-October-2026
+  * @brief   Item model holding the structure (documents, sections, ...) of a project.
+**/
+
+#include "structuremodel.h"
+
+/**************************************** CONSTRUCTOR *******************************************/
+structureModel::structureModel(QObject *parent) :
+    QAbstractItemModel(parent)
+{
+    documentFont.setBold(true);
+}
+
+structureModel::~structureModel() {
+}
+
+/**************************************** METHODS ***********************************************/
+
+QModelIndex structureModel::index(int row, int column, const QModelIndex &parent) const {
+    if(column != 0 || row < 0)
+        return QModelIndex();
+    if(!parent.isValid())
+        return row < documents.size() ? createIndex(row, 0, documents[row]) : QModelIndex();
+
+    const CDC_structureNode &node = nodes[static_cast<int>(parent.internalId())];
+    return row < node.children.size() ? createIndex(row, 0, node.children[row]) : QModelIndex();
+}
+
+QModelIndex structureModel::parent(const QModelIndex &child) const {
+    if(!child.isValid())
+        return QModelIndex();
+    int parentSlot = nodes[static_cast<int>(child.internalId())].parent;
+    if(parentSlot == -1)
+        return QModelIndex();
+    return createIndex(nodes[parentSlot].row, 0, parentSlot);
+}
+
+int structureModel::rowCount(const QModelIndex &parent) const {
+    if(!parent.isValid())
+        return documents.size();
+    if(parent.column() != 0)
+        return 0;
+    return nodes[static_cast<int>(parent.internalId())].children.size();
+}
+
+int structureModel::columnCount(const QModelIndex & /*parent*/) const {
+    return 1;
+}
+
+QVariant structureModel::data(const QModelIndex &index, int role) const {
+    if(!index.isValid())
+        return QVariant();
+    const CDC_structureNode &node = nodes[static_cast<int>(index.internalId())];
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return node.name;
+    case Qt::ToolTipRole:
+        switch (node.type) {
+        case CDC_docStructuralElementType::document:      return QString("Document tag: " + node.tag);
+        case CDC_docStructuralElementType::section:       return QString("Section tag: " + node.tag);
+        case CDC_docStructuralElementType::subsection:    return QString("Subsection tag: " + node.tag);
+        case CDC_docStructuralElementType::subsubsection: return QString("Subsubsection tag: " + node.tag);
+        case CDC_docStructuralElementType::paragraph:     return QString("Paragraph tag: " + node.tag);
+        }
+        return QVariant();
+    case Qt::FontRole:
+        if(node.type == CDC_docStructuralElementType::document)
+            return documentFont;
+        return QVariant();
+    case CDC_docStructuralElementRole::Tag:
+        return node.tag;
+    case CDC_docStructuralElementRole::Line:
+        return node.line;
+    case CDC_docStructuralElementRole::Type:
+        return static_cast<int>(node.type);
+    case CDC_docStructuralElementRole::Doc:
+        return nodes[node.document].tag;
+    case CDC_docStructuralElementRole::Index:
+        if(node.type == CDC_docStructuralElementType::document)
+            return QVariant();
+        return node.fileIndex;
+    default:
+        return QVariant();
+    }
+}
+
+Qt::ItemFlags structureModel::flags(const QModelIndex &index) const {
+    if(!index.isValid())
+        return Qt::NoItemFlags;
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+void structureModel::clear() {
+    beginResetModel();
+    nodes.clear();
+    freeSlots.clear();
+    documents.clear();
+    endResetModel();
+}
+
+int structureModel::appendDocument(const QString &tag, const QString &name) {
+    int row = documents.size();
+    beginInsertRows(QModelIndex(), row, row);
+    int slot = allocateNode();
+    CDC_structureNode &node = nodes[slot];
+    node.tag       = tag;
+    node.name      = name;
+    node.line      = -1;
+    node.fileIndex = -1;
+    node.type      = CDC_docStructuralElementType::document;
+    node.parent    = -1;
+    node.row       = row;
+    node.document  = slot;
+    documents.append(slot);
+    endInsertRows();
+    return row;
+}
+
+void structureModel::setDocumentStructure(int row, const QList<QList<CDC_docStructuralElement> > &files) {
+    if(row < 0 || row >= documents.size())
+        return;
+
+    // Lay the new elements out as a tree first, then only apply what differs from the current one.
+    // Slot 0 of the draft is the document.
+    QVector<CDC_draftNode> draft(1);
+    draft[0].element   = NULL;
+    draft[0].fileIndex = -1;
+    int lastAtDepth[5]; // Draft slot of the last element appended at each depth (0 is the document)
+    for (int i = 0; i < files.length(); ++i) {
+        // Each file's list starts with a section, so its elements never end up under another file's
+        lastAtDepth[0] = 0;
+        int deepest = 0;
+        for (int j = 0; j < files[i].length(); ++j) {
+            const CDC_docStructuralElement &se = files[i][j];
+            int depth = static_cast<int>(se.type);
+            if(depth < 1 || depth > deepest + 1 || depth > 4)
+                continue; // not reachable with lists from inputFileParser, but keep the tree sane
+
+            CDC_draftNode node;
+            node.element   = &se;
+            node.fileIndex = i;
+            draft.append(node);
+            draft[lastAtDepth[depth-1]].children.append(draft.size() - 1);
+
+            lastAtDepth[depth] = draft.size() - 1;
+            deepest = depth;
+        }
+    }
+    mergeChildren(documents[row], draft, 0);
+}
+
+// PRIVATE ------------------------------------------------------------------------
+int structureModel::allocateNode() {
+    int slot;
+    if(!freeSlots.isEmpty()) {
+        slot = freeSlots.last();
+        freeSlots.removeLast();
+    }
+    else {
+        slot = nodes.size();
+        nodes.resize(slot + 1);
+    }
+    return slot;
+}
+
+QModelIndex structureModel::indexOfSlot(int slot) const {
+    return createIndex(nodes[slot].row, 0, slot);
+}
+
+void structureModel::renumberChildren(int parentSlot, int from) {
+    const QVector<int> &children = nodes[parentSlot].children;
+    for (int i = from; i < children.size(); ++i)
+        nodes[children[i]].row = i;
+}
+
+void structureModel::mergeChildren(int parentSlot, const QVector<CDC_draftNode> &draft, int draftSlot) {
+    QModelIndex parentIndex = indexOfSlot(parentSlot);
+    const QVector<int> &wanted = draft[draftSlot].children;
+
+    // Current children not matched yet, by tag. Tags are expected to be unique; with repeated ones
+    // the first occurrence is matched and the others are simply recreated.
+    QHash<QString, int> slotsByTag;
+    for (int i = nodes[parentSlot].children.size() - 1; i >= 0; --i)
+        slotsByTag.insert(nodes[nodes[parentSlot].children[i]].tag, nodes[parentSlot].children[i]);
+
+    int row = 0; // Everything above this row already matches the draft
+    for (int i = 0; i < wanted.size(); ++i) {
+        const CDC_draftNode &dn = draft[wanted[i]];
+        int slot = slotsByTag.value(dn.element->tag, -1);
+
+        if(slot == -1) { // New element: insert it here
+            beginInsertRows(parentIndex, row, row);
+            slot = allocateNode();
+            nodes[parentSlot].children.insert(row, slot);
+            renumberChildren(parentSlot, row);
+            fillNode(slot, parentSlot, dn, draft);
+            endInsertRows();
+        }
+        else {
+            slotsByTag.remove(dn.element->tag);
+            int match = nodes[slot].row;
+            if(match > row) // The rows in between are gone
+                removeChildren(parentSlot, row, match - 1, slotsByTag);
+            // Same element: refresh its data in place and go down one level
+            CDC_structureNode &node = nodes[slot];
+            if(node.name != dn.element->name || node.line != dn.element->line || node.fileIndex != dn.fileIndex) {
+                node.name      = dn.element->name;
+                node.line      = dn.element->line;
+                node.fileIndex = dn.fileIndex;
+                QModelIndex idx = indexOfSlot(slot);
+                emit dataChanged(idx, idx);
+            }
+            mergeChildren(slot, draft, wanted[i]);
+        }
+        row++;
+    }
+
+    int count = nodes[parentSlot].children.size();
+    if(row < count) // Leftovers that are not in the draft anymore
+        removeChildren(parentSlot, row, count - 1, slotsByTag);
+}
+
+void structureModel::removeChildren(int parentSlot, int first, int last, QHash<QString, int> &slotsByTag) {
+    beginRemoveRows(indexOfSlot(parentSlot), first, last);
+    for (int i = first; i <= last; ++i) {
+        int slot = nodes[parentSlot].children[i];
+        if(slotsByTag.value(nodes[slot].tag, -1) == slot)
+            slotsByTag.remove(nodes[slot].tag);
+        freeSubtree(slot);
+    }
+    nodes[parentSlot].children.remove(first, last - first + 1);
+    renumberChildren(parentSlot, first);
+    endRemoveRows();
+}
+
+void structureModel::fillNode(int slot, int parentSlot, const CDC_draftNode &dn, const QVector<CDC_draftNode> &draft) {
+    // nodes may be reallocated by allocateNode(): no references are held across those calls
+    nodes[slot].tag       = dn.element->tag;
+    nodes[slot].name      = dn.element->name;
+    nodes[slot].line      = dn.element->line;
+    nodes[slot].fileIndex = dn.fileIndex;
+    nodes[slot].type      = dn.element->type;
+    nodes[slot].parent    = parentSlot;
+    nodes[slot].document  = nodes[parentSlot].document;
+    for (int i = 0; i < dn.children.size(); ++i) {
+        int child = allocateNode();
+        nodes[slot].children.append(child);
+        nodes[child].row = i;
+        fillNode(child, slot, draft[dn.children[i]], draft);
+    }
+}
+
+void structureModel::freeSubtree(int slot) {
+    for (int i = 0; i < nodes[slot].children.size(); ++i)
+        freeSubtree(nodes[slot].children[i]);
+    nodes[slot].children.clear();
+    nodes[slot].tag.clear();
+    nodes[slot].name.clear();
+    freeSlots.append(slot);
+}
@@ -0,0 +1,115 @@
+/**
+  *****************************************************************************
+  *  _____                  ______
+  * /  __ \                 |  _  \
+  * | /  \/_ __ ___  ___ ___| | | |___   ___ ___
+  * | |   | '__/ _ \/ __/ __| | | / _ \ / __/ __|
+  * | \__/\ | | |_| \__ \__ \ |/ / |_| | (__\__ \
+  *  \____/_|  \___/|___/___/___/ \___/ \___|___/
+  *
+  *****************************************************************************
+  *
+  * @file    structuremodel.h
+  * @author  Martin Vincent Bloedorn
+  * @version V0.1.0
+  * @date    17-October-2026
+  * @brief   Item model holding the structure (documents, sections, ...) of a project.
+**/
+
+#ifndef STRUCTUREMODEL_H
+#define STRUCTUREMODEL_H
+
+#include <QAbstractItemModel>
+#include <QVector>
+#include <QHash>
+#include <QFont>
+
+#include "cdcdefs.h"
+
+/**
+ * @brief Read-only tree model of the project's structure, one top-level row per document.
+ * All nodes live in a single flat array; each node refers to its parent and children by their slot in
+ * that array, and the slot is what goes into QModelIndex::internalId() . Slots of removed nodes are
+ * reused, so the array never shifts. Role data (see CDC_docStructuralElementRole ) is computed from the
+ * node when requested, instead of being stored in \b QVariant s.
+ */
+class structureModel : public QAbstractItemModel
+{
+    Q_OBJECT
+public:
+    structureModel(QObject *parent = 0);
+    ~structureModel();
+
+    // QAbstractItemModel interface
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
+    QModelIndex parent(const QModelIndex &child) const;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    Qt::ItemFlags flags(const QModelIndex &index) const;
+
+    /// \brief Removes all documents (resets the model).
+    void clear();
+
+    /**
+     * @brief Appends a document row, with no structural elements yet.
+     * @return Row of the new document.
+     */
+    int appendDocument(const QString &tag, const QString &name);
+
+    /**
+     * @brief Replaces the structural elements of the document at \em row .
+     * @param row Row of the document.
+     * @param files Structural elements of each input file of the document, as given by
+     * inputFileParser::extractStructure() (file order, never more than one level deeper than the previous).
+     * The new elements are matched by tag against the current ones, level by level, and only the
+     * differences are applied (row insertions/removals, dataChanged() ). Elements that are kept keep
+     * their indexes, so views preserve expansion, selection and scroll position on their own.
+     */
+    void setDocumentStructure(int row, const QList<QList<CDC_docStructuralElement> > &files);
+
+private:
+    typedef struct {
+        QString tag;
+        QString name;
+        int line;                   /// -1 for documents
+        int fileIndex;              /// -1 for documents
+        CDC_docStructuralElementType type;
+        int parent;                 /// Slot of the parent node, -1 for documents
+        int row;                    /// Row under the parent
+        int document;               /// Slot of the document node the node belongs to
+        QVector<int> children;      /// Slots of the children, in row order
+    } CDC_structureNode;
+
+    /// Element of the tree being merged in by setDocumentStructure()
+    typedef struct {
+        const CDC_docStructuralElement * element; /// NULL for the document
+        int fileIndex;
+        QVector<int> children;      /// Slots of the children in the draft
+    } CDC_draftNode;
+
+    QVector<CDC_structureNode> nodes;   /// All nodes, by slot
+    QVector<int> freeSlots;             /// Slots that can be reused
+    QVector<int> documents;             /// Slots of the document nodes, by row
+    QFont documentFont;                 /// Font used for document rows
+
+    int  allocateNode();
+    void freeSubtree(int slot);
+    QModelIndex indexOfSlot(int slot) const;
+    void renumberChildren(int parentSlot, int from);
+
+    /**
+     * @brief Makes the children of \em parentSlot match the ones of \em draftSlot , recursively.
+     * Emits the minimal row insertions/removals for each level, plus dataChanged() for kept elements
+     * whose data changed.
+     */
+    void mergeChildren(int parentSlot, const QVector<CDC_draftNode> &draft, int draftSlot);
+
+    /// \brief Removes rows \em first to \em last of \em parentSlot , dropping them from \em slotsByTag too.
+    void removeChildren(int parentSlot, int first, int last, QHash<QString, int> &slotsByTag);
+
+    /// \brief Fills the freshly allocated node \em slot (and its subtree) from the draft node \em dn .
+    void fillNode(int slot, int parentSlot, const CDC_draftNode &dn, const QVector<CDC_draftNode> &draft);
+};
+
+#endif // STRUCTUREMODEL_H